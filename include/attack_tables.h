@@ -0,0 +1,68 @@
+#ifndef ATTACK_TABLES_H
+#define ATTACK_TABLES_H
+
+#include <cstdint>
+#include "bit_utils.cpp"
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+const u64 FILE_A = 0x0101010101010101ULL;
+const u64 FILE_H = FILE_A << 7;
+const u64 RANK_1 = 0xFFULL;
+const u64 RANK_2 = RANK_1 << 8;
+const u64 RANK_7 = RANK_1 << 48;
+const u64 RANK_8 = RANK_1 << 56;
+
+// Lookup data for one square of a sliding piece. Attack sets for every relevant
+// occupancy live in a shared table starting at offset. Builds with BMI2 enabled
+// (make BMI2=1) index the table with PEXT instead of the magic multiply.
+struct Magic
+{
+    u64 mask;   // Relevant occupancy (the rays without the board edge)
+    u64 magic;  // Multiplier mapping each occupancy subset to a unique index
+    unsigned offset;
+    unsigned shift;
+
+    unsigned index(u64 occupied) const
+    {
+#ifdef __BMI2__
+        return offset + static_cast<unsigned>(_pext_u64(occupied, mask));
+#else
+        return offset + static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+#endif
+    }
+};
+
+extern u64 BETWEEN[64][64]; // Squares strictly between two squares on a shared rank, file or diagonal
+extern u64 LINE[64][64];    // Whole rank, file or diagonal through two squares (empty if not aligned)
+
+extern u64 KNIGHT_ATTACKS[64];
+extern u64 KING_ATTACKS[64];
+extern u64 PAWN_ATTACKS[2][64]; // Squares attacked by a pawn, [0] for white and [1] for black
+
+extern Magic ROOK_MAGICS[64];
+extern Magic BISHOP_MAGICS[64];
+extern u64 ROOK_ATTACK_TABLE[102400];
+extern u64 BISHOP_ATTACK_TABLE[5248];
+
+// Build the leaper and sliding piece lookup tables. To be done once at start of program.
+void init_attack_tables();
+
+inline u64 rook_attacks(int square, u64 occupied)
+{
+    return ROOK_ATTACK_TABLE[ROOK_MAGICS[square].index(occupied)];
+}
+
+inline u64 bishop_attacks(int square, u64 occupied)
+{
+    return BISHOP_ATTACK_TABLE[BISHOP_MAGICS[square].index(occupied)];
+}
+
+inline u64 queen_attacks(int square, u64 occupied)
+{
+    return rook_attacks(square, occupied) | bishop_attacks(square, occupied);
+}
+
+#endif // ATTACK_TABLES_H
@@ -0,0 +1,18 @@
+// bench.h
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "search_limits.h"
+#include <cstdint>
+#include <ostream>
+
+/// Depth every bench position is searched to unless another is given
+const int BENCH_DEPTH = 9;
+
+/// Search each bench position to depth on one thread with an empty transposition table, then write
+/// the nodes per position, the total, time and nodes per second. The search is deterministic, so the
+/// returned total changes only when search behaviour does. Once limits is stopped no further position
+/// is started, and the totals cover the positions searched so far.
+std::uint64_t run_bench(std::ostream &out, int depth = BENCH_DEPTH, const SearchLimits *limits = nullptr);
+
+#endif // BENCH_H
@@ -3,6 +3,8 @@
 
 #include <cstdint>
 
+typedef unsigned long long u64;
+
 inline int get_LSB_index(uint64_t bitboard)
 {
     if (bitboard == 0)
@@ -10,4 +12,17 @@ inline int get_LSB_index(uint64_t bitboard)
     return __builtin_ctzll(bitboard); // Count trailing zeros to find the index of the LSB
 }
 
-#endif // CHAR_UTILS
+// Return the index of the LSB and clear it from the bitboard (bitboard must be non zero)
+inline int pop_LSB(u64 &bitboard)
+{
+    int index = __builtin_ctzll(bitboard);
+    bitboard &= bitboard - 1;
+    return index;
+}
+
+inline int count_bits(u64 bitboard)
+{
+    return __builtin_popcountll(bitboard);
+}
+
+#endif // BIT_UTILS
@@ -5,15 +5,37 @@
 #include <vector>
 #include "square.h"
 #include "move.h"
-#include <stack>
+#include <array>
+#include <cstddef>
 #include "move_state.h"
 #include "char_utils.h"
-#include <unordered_set>
 #include "zobrist_values.h"
-#include "threefold_map.h"
+#include "piece_square_tables.h"
+#include "bit_utils.cpp"
 
 typedef unsigned long long u64;
 const std::string START_POS = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+/// Plies of game history kept for repetition checks, longer games drop what can no longer repeat
+const std::size_t MAX_GAME_PLY = 1024;
+/// Deepest line the search can hold on the board at once, null moves and quiescence included
+const std::size_t MAX_SEARCH_PLY = 128;
+
+// Indexes into piece_bitboards (matches piece_to_index)
+enum PieceIndex
+{
+    WHITE_PAWN,
+    WHITE_KNIGHT,
+    WHITE_BISHOP,
+    WHITE_ROOK,
+    WHITE_QUEEN,
+    WHITE_KING,
+    BLACK_PAWN,
+    BLACK_KNIGHT,
+    BLACK_BISHOP,
+    BLACK_ROOK,
+    BLACK_QUEEN,
+    BLACK_KING
+};
 
 class BoardRepresentation
 {
@@ -33,6 +55,8 @@ public:
     void make_move(const Move &move);                // Play move internally
     void make_move_literal(const std::string &move); // make move and store position
     void undo_move(const Move &move);                // Undo a move internally
+    void make_null_move();                           // Pass the turn without moving, for null-move pruning
+    void undo_null_move();                           // Undo make_null_move
 
     // Methods for specific game states
     bool move_captures_king(const Move &) const; // Check if a move captures a king piece
@@ -47,23 +71,47 @@ public:
     bool white_to_move;                   // True if it's white's turn, false for black
     bool is_opponent_piece(char &) const; // Check if a piece is an opponent piece
     bool is_only_between(const Square &square_a, const Square &square_b, const Square &between_square) const;
-    std::uint64_t zobrist_hash() const;
+    std::uint64_t zobrist_hash() const { return hash_key; } // Incrementally maintained position hash
+    std::uint64_t compute_zobrist_hash() const;            // Full recompute from the board
 
     // En passant square
     Square en_passant_square; // -1 if no en passant is available
 
     int halfmove_clock;  // Fifty-move rule counter
     int fullmove_number; // Number of full moves
-    std::unordered_set<Square> non_empty_squares;
+
+    // Bitboards for iterating pieces (bit index is rank * 8 + file)
+    u64 piece_bitboards[12];
+    u64 white_pieces, black_pieces, occupied;
+    std::uint64_t hash_key;
+    std::uint64_t pawn_key; // Zobrist hash of the pawns alone, keys the pawn hash table
+
+    // Evaluation terms kept up to date as pieces are placed and removed
+    int material[2];   // Piece values without kings, white then black; their sum is the game phase
+    int midgame_score; // Material and piece-square values, white minus black, kings on their midgame table
+    int endgame_score; // Same with the kings on their endgame table
+
     bool is_in_check;
-    ThreefoldMap threefold_map;
+    int plies_from_null; // Moves played since the last null move, repetitions cannot reach across one
+
+    /// True if the position repeats one from the last plies_from_root plies, or occurred twice before them
+    bool is_repetition(int plies_from_root) const;
 
 private:
     // Helper methods for legal move generation and game status checks
     wchar_t get_piece_at_square(int square) const; // Get the piece at a square
-    void set_non_empty_squares();
+    void set_bitboards();
+    std::uint64_t castling_and_en_passant_hash() const;
+    void place_piece(char piece, int8_t rank, int8_t file); // Put a piece on an empty square
+    void remove_piece(int8_t rank, int8_t file);            // Clear an occupied square
+    int set_square(char piece, int8_t rank, int8_t file);   // place_piece without hash and score updates, returns the piece index
+    int clear_square(int8_t rank, int8_t file);             // remove_piece without hash and score updates, returns the piece index
+    void update_scores(int piece_index, int square, int sign); // Add (sign 1) or take out (-1) a piece from the evaluation terms and pawn key
+    void save_state(char captured_piece);                      // Record what undoing the next move needs
 
-    std::stack<MoveState> move_stack;
+    // Undo entries of every move played on this board, indexed by ply from the loaded position
+    std::array<MoveState, MAX_GAME_PLY + MAX_SEARCH_PLY> move_history;
+    std::size_t history_size;
 };
 
 #endif // BOARD_REPRESENTATION_H
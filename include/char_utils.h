@@ -21,4 +21,40 @@ inline char to_lower(char c)
     return c;
 }
 
+// Index of a piece in the bitboard and zobrist tables (white pieces 0-5, black pieces 6-11)
+inline int piece_to_index(char piece)
+{
+    switch (piece)
+    {
+    case 'P':
+        return 0; // White Pawn
+    case 'N':
+        return 1; // White Knight
+    case 'B':
+        return 2; // White Bishop
+    case 'R':
+        return 3; // White Rook
+    case 'Q':
+        return 4; // White Queen
+    case 'K':
+        return 5; // White King
+
+    case 'p':
+        return 6; // Black Pawn
+    case 'n':
+        return 7; // Black Knight
+    case 'b':
+        return 8; // Black Bishop
+    case 'r':
+        return 9; // Black Rook
+    case 'q':
+        return 10; // Black Queen
+    case 'k':
+        return 11; // Black King
+
+    default:
+        return -1; // 'e' or invalid
+    }
+}
+
 #endif // CHAR_UTILS
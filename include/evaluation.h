@@ -12,19 +12,36 @@
 #include <atomic>
 #include <vector>
 #include "transposition_table.h"
+#include "search_limits.h"
+#include "move_picker.h"
+#include "pawn_hash_table.h"
 
 typedef unsigned long long u64;
 
 const int MATE_SCORE = 1000000;
-const double TRADE_BONUS_FACTOR = 0.5;
+const int TRADE_BONUS_DIVISOR = 2; // The material lead grows by the traded fraction of material divided by this
 const int DOUBLED_PAWN_PENALTY = 25;
 const int CLOSE_PAWN_BONUS = 25;
 const int OPEN_KING_FILE_PENALTY = 50;
-const double ENDGAME_MATERIAL_CONDITION = 0.3;
-const double EARLY_GAME_MATERIAL_CONDITION = 0.7;
+const int ISOLATED_PAWN_PENALTY = 10;
+const int PASSED_PAWN_BONUS[8] = {0, 5, 10, 20, 35, 60, 100, 0}; // By rank counted from the pawn's own side
+const int STARTING_MATERIAL = 7800; // Piece values without kings in the starting position
+const int ENDGAME_MATERIAL = 2340;  // Endgame tables apply fully at or below this much material
+const int MIDGAME_MATERIAL = 5460;  // Midgame tables apply fully at or above this much material
 const int MIN_DEPTH_SEARCHED = 1;
 const float KING_PIECE_SQUARE_MAP_MODIFIER = 1.5; // increase king safety weight
 const int DEFAULT_SEARCH_TIME_MS = 1000;
+const int GOOD_CAPTURE_SCORE = 3000; // compute_move_score gives winning and equal captures at least this
+const int MAX_SEARCH_DEPTH = 63; // Deepest ply the transposition table can record
+const int MAX_SEARCH_THREADS = 64;
+const int ASPIRATION_WINDOW = 50;      // Half width of the first root window around the last score
+const int ASPIRATION_GROWTH = 4;       // Window multiplier after each fail
+const int MAX_ASPIRATION_WINDOW = 800; // Wider than this and we search the full window instead
+const int NULL_MOVE_MIN_DEPTH = 3;     // Shallowest remaining depth where we try passing
+const int NULL_MOVE_DEEP_DEPTH = 7;    // From this depth the null-move search is reduced by 3 plies instead of 2
+const int LMR_MIN_DEPTH = 3;           // Shallowest remaining depth where late moves are reduced
+const int LMR_MIN_MOVE_NUMBER = 4;     // Moves before this one in the ordering are never reduced
+const int LMR_TABLE_SIZE = 64;         // Depths and move numbers past this share the last entry
 
 struct Evaluation
 {
@@ -45,6 +62,12 @@ struct Evaluation
     }
 };
 
+/// Milliseconds to spend on this move, or forced_time when it is not negative
+std::chrono::milliseconds allocate_search_time(BoardRepresentation &board_representation,
+                                               int wtime, int btime,
+                                               int winc, int binc,
+                                               int forced_time);
+
 Evaluation find_best_move(BoardRepresentation &board_representation,
                           TranspositionTable &transposition_table,
                           const bool am_logging = false,
@@ -52,66 +75,67 @@ Evaluation find_best_move(BoardRepresentation &board_representation,
                           const int btime = 30000,
                           const int winc = 0,
                           const int binc = 0,
-                          const int forced_time = -1);
-
-void ponder(BoardRepresentation &board_representation,
-            TranspositionTable &transposition_table,
-            Move &next_ponder_move,
-            Move &best_move_found,
-            bool am_logging,
-            const std::atomic<bool> &stop_pondering,
-            const std::atomic<bool> &hard_stop,
-            const int wtime = 30000,
-            const int btime = 30000,
-            const int winc = 0,
-            const int binc = 0,
-            const int forced_time = -1);
+                          const int forced_time = -1,
+                          SearchLimits *limits = nullptr,
+                          const int threads = 1);
 
 Evaluation run_iterative_deepening(BoardRepresentation &board_representation,
                                    TranspositionTable &transposition_table,
                                    bool am_logging,
-                                   std::function<bool()> stop_condition);
+                                   SearchLimits &limits,
+                                   int threads = 1);
 
 Evaluation search(BoardRepresentation &board_representation,
                   TranspositionTable &transposition_table,
-                  std::vector<Move> &top_depth_moves,
+                  MoveList &top_depth_moves,
                   int depth,
                   int alpha,
                   int beta,
-                  double remaining_material_ratio,
                   int starting_depth,
-                  const std::function<bool()> &should_stop,
-                  bool &stop_flag);
+                  SearchLimits &limits,
+                  SearchHeuristics &heuristics,
+                  int ply,
+                  bool &stop_flag,
+                  bool allow_null_move = true);
 
 int search_captures(BoardRepresentation &board_representation,
+                    TranspositionTable &transposition_table,
+                    SearchLimits &limits,
                     int alpha,
-                    int beta,
-                    double remaining_material_ratio);
+                    int beta);
 
-void sort_for_pruning(std::vector<Move> &move_list,
+void sort_for_pruning(MoveList &move_list,
                       const BoardRepresentation &board_representation);
 
-void bump_best_move_to_front(std::vector<Move> &move_list,
+void bump_best_move_to_front(MoveList &move_list,
                              const Move &best_move);
 
 int get_piece_value(char piece);
 
-int evaluate(BoardRepresentation &board_representation,
-             double remaining_material_ratio);
+int evaluate(BoardRepresentation &board_representation);
 
 double get_remaining_material(BoardRepresentation &board_representation);
 
+/// Call after make_move: true if the move just played checks the opponent king
+bool gives_check(const BoardRepresentation &board_representation);
+
+/// True if the side to move has a knight, bishop, rook or queen
+bool has_non_pawn_material(const BoardRepresentation &board_representation);
+
+/// Material the side to move gains from the exchange started by a capture, in centipawns
+int static_exchange_evaluation(const BoardRepresentation &board_representation,
+                               const Move &move);
+
 int compute_move_score(const Move &move,
                        const BoardRepresentation &board_representation);
 
-int evaluate_king_safety(const BoardRepresentation &board_representation,
-                         double remaining_material_ratio,
-                         const std::vector<Square> &friendly_pawns,
-                         const std::vector<Square> &opp_pawns,
-                         const Square &king_pos,
-                         const Square &opp_king_pos);
+/// King shelter difference for the side to move, only for kings that gave up castling
+int evaluate_king_safety(const BoardRepresentation &board_representation, int material_count);
+
+/// Doubled pawn penalties for the friendly side minus those of the opponent
+int evaluate_doubled_pawns(u64 friendly_pawns, u64 opp_pawns);
 
-int evaluate_doubled_pawns(const std::vector<Square> &friendly_pawns,
-                           const std::vector<Square> &opp_pawns);
+/// Doubled, isolated and passed pawn terms from white's point of view; depends on the pawns alone
+int evaluate_pawn_structure(u64 white_pawns, u64 black_pawns);
 
 #endif // EVALUATION_H
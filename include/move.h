@@ -2,47 +2,91 @@
 #define MOVE_H
 
 #include "square.h"
+#include <cstdint>
 #include <string>
 #include <iostream>
 
+// Special move kinds stored in the top two bits of a move
+enum MoveType : std::uint16_t
+{
+  NORMAL_MOVE = 0,
+  PROMOTION = 1,
+  EN_PASSANT = 2,
+  CASTLE = 3
+};
+
+// A move packed into 16 bits:
+// bits 0-5 start square index, bits 6-11 target square index,
+// bits 12-13 promotion piece (knight, bishop, rook, queen), bits 14-15 move type.
+// The all zero move (a1a1) can never be played and marks an empty move.
 struct Move
 {
-  Square start_square; // Starting square for the move
-  Square to_square;    // Ending square for the move
+  std::uint16_t data;
 
-  bool is_enpassant;
-  bool is_castle;
-  char promotion_piece;
+  Move(int start_index, int to_index, MoveType type = NORMAL_MOVE, char promotion = 'x')
+      : data(static_cast<std::uint16_t>(start_index | (to_index << 6) |
+                                        (promotion_code(promotion) << 12) | (type << 14)))
+  {
+  }
 
   Move(Square new_start_square, Square new_to_square,
        bool enpassant = false, bool castle = false,
        char promotion = 'x')
-      : start_square(new_start_square),
-        to_square(new_to_square),
-        is_enpassant(enpassant),
-        is_castle(castle),
-        promotion_piece(promotion)
+      : Move(new_start_square.to_index(), new_to_square.to_index(),
+             enpassant ? EN_PASSANT : castle ? CASTLE
+                                  : promotion != 'x' ? PROMOTION
+                                                     : NORMAL_MOVE,
+             promotion)
   {
   }
 
-  Move()
-      : start_square(-1, -1),
-        to_square(-1, -1),
-        is_enpassant(false),
-        is_castle(false),
-        promotion_piece('x')
+  Move() : data(0) {}
+
+  std::string to_UCI() const;
+
+  // Square indices in bitboard order
+  int from() const { return data & 0x3F; }
+  int to() const { return (data >> 6) & 0x3F; }
+  MoveType type() const { return static_cast<MoveType>(data >> 14); }
+
+  Square start_square() const { return Square(static_cast<int8_t>(from() / 8), static_cast<int8_t>(from() % 8)); }
+  Square to_square() const { return Square(static_cast<int8_t>(to() / 8), static_cast<int8_t>(to() % 8)); }
+
+  bool is_enpassant() const { return type() == EN_PASSANT; }
+  bool is_castle() const { return type() == CASTLE; }
+  bool is_promotion() const { return type() == PROMOTION; }
+
+  // Lower case promotion piece, 'x' when the move does not promote
+  char promotion_piece() const
   {
+    return is_promotion() ? "nbrq"[(data >> 12) & 3] : 'x';
   }
-  std::string to_UCI() const;
+
   bool is_instantiated() const
   {
-    return to_square.exists() && start_square.exists();
+    return data != 0;
   }
 
   // Overload the equality operator
   bool operator==(const Move &other) const
   {
-    return start_square == other.start_square && to_square == other.to_square && promotion_piece == other.promotion_piece;
+    return data == other.data;
+  }
+
+private:
+  static int promotion_code(char promotion)
+  {
+    switch (promotion)
+    {
+    case 'b':
+      return 1;
+    case 'r':
+      return 2;
+    case 'q':
+      return 3;
+    default:
+      return 0;
+    }
   }
 };
 
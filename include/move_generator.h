@@ -3,78 +3,59 @@
 
 #include "board_representation.h"
 #include "move.h"
+#include "move_list.h"
 #include "square.h" // Ensure Square is included
 #include <vector>
 #include <iostream>
 #include <cctype>
 #include <cassert>
-#include "square_to_square_map.cpp"
 #include <algorithm>
 #include "char_utils.h"
 #include "bit_utils.cpp"
+#include "attack_tables.h"
 
 typedef unsigned long long u64;
 
 // Function declarations with variable names for clarity:
 
-// Generates all pseudo-legal moves, considering pins and attacked squares
-void generate_pseudo_legal_moves(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    std::vector<SquareToSquareMap> &attacked_squares,
-    Square &king_position);
-
-// Generates all legal moves from the current board state
+// Generates all legal moves from the current board state (sets is_in_check on the board)
 u64 generate_legal_moves(
     BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
+    MoveList &move_list,
     bool only_captures = false);
 
-// Generates pawn moves from a given square
-void generate_pawn_move(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    const Square &on_square,
-    std::vector<SquareToSquareMap> &attacked_squares);
+// Counts the legal moves without storing the non-pawn ones (sets is_in_check on the board), for perft leaves
+u64 count_legal_moves(
+    BoardRepresentation &board_representation);
 
-// Generates rook moves from a given square
-void generate_rook_move(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    const Square &on_square,
-    std::vector<SquareToSquareMap> &attacked_squares);
+// Generates pawn moves (including en passant) from a given square
+void generate_pawn_moves(
+    const BoardRepresentation &board_representation,
+    MoveList &move_list,
+    int from_square,
+    u64 allowed_squares,
+    bool only_captures);
 
-// Generates bishop moves from a given square
-void generate_bishop_move(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    const Square &on_square,
-    std::vector<SquareToSquareMap> &attacked_squares);
-
-// Generates knight moves from a given square
-void generate_knight_move(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    const Square &on_square,
-    std::vector<SquareToSquareMap> &attacked_squares);
-
-// Generates queen moves from a given square
-void generate_queen_move(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    const Square &on_square,
-    std::vector<SquareToSquareMap> &attacked_squares);
-
-// Generates king moves from a given square
-void generate_king_move(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    const Square &on_square,
-    std::vector<SquareToSquareMap> &attacked_squares);
-
-// Generates castling moves if available
+// Generates castling moves if available and legal
 void generate_castle(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list);
+    const BoardRepresentation &board_representation,
+    MoveList &move_list);
+
+// Bitboard of pieces of either colour attacking a square given an occupancy
+u64 attackers_to(
+    const BoardRepresentation &board_representation,
+    int square,
+    u64 occupied);
+
+// Checks if a square is attacked by the given side
+bool is_square_attacked_by(
+    const BoardRepresentation &board_representation,
+    int square,
+    bool by_white);
+
+// Friendly pieces that are the only blocker between their king and an enemy slider
+u64 get_pinned_pieces(
+    const BoardRepresentation &board_representation,
+    int king_square);
 
 #endif // MOVE_GENERATOR
@@ -0,0 +1,40 @@
+#ifndef MOVE_LIST_H
+#define MOVE_LIST_H
+
+#include "move.h"
+#include <cstddef>
+
+// No legal chess position has more than 218 moves
+const std::size_t MAX_MOVES = 256;
+
+// Fixed capacity list of moves stored inline, so move lists can live on the stack
+// of each search node without touching the heap
+class MoveList
+{
+private:
+    Move moves_[MAX_MOVES];
+    std::size_t size_;
+
+public:
+    MoveList() : moves_(), size_(0) {}
+
+    void push_back(const Move &move)
+    {
+        moves_[size_++] = move;
+    }
+
+    void clear() { size_ = 0; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    Move &operator[](std::size_t index) { return moves_[index]; }
+    const Move &operator[](std::size_t index) const { return moves_[index]; }
+
+    // Expose iterators to allow range-based for loops and std algorithms
+    Move *begin() { return moves_; }
+    Move *end() { return moves_ + size_; }
+    const Move *begin() const { return moves_; }
+    const Move *end() const { return moves_ + size_; }
+};
+
+#endif // MOVE_LIST_H
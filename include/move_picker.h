@@ -0,0 +1,85 @@
+#ifndef MOVE_PICKER_H
+#define MOVE_PICKER_H
+
+#include "board_representation.h"
+#include "move.h"
+#include "move_list.h"
+#include <cstddef>
+
+/// History scores stay within +-MAX_HISTORY
+const int MAX_HISTORY = 16384;
+
+// Quiet move ordering learned during one search: killers per ply, butterfly history per side and
+// from/to square, and the reply that last refuted each move. One per search thread, made fresh for each search.
+class SearchHeuristics
+{
+private:
+    Move killers[MAX_SEARCH_PLY][2];
+    int history[2][64][64];
+    Move countermoves[64][64];
+    Move played[MAX_SEARCH_PLY]; // Move made at each ply on the current path, empty for a null move
+
+public:
+    SearchHeuristics() : killers(), history(), countermoves(), played() {}
+
+    /// Record the move about to be searched at ply, an empty move for a null move
+    void set_played(int ply, const Move &move) { played[ply] = move; }
+
+    /// The move that led to the node at ply
+    Move previous_move(int ply) const { return ply > 0 ? played[ply - 1] : Move(); }
+
+    bool is_killer(int ply, const Move &move) const { return killers[ply][0] == move || killers[ply][1] == move; }
+    Move killer(int ply, int slot) const { return killers[ply][slot]; }
+    Move countermove(const Move &previous) const { return countermoves[previous.from()][previous.to()]; }
+    int history_score(bool white, const Move &move) const { return history[white][move.from()][move.to()]; }
+
+    /// A quiet move caused a beta cutoff at ply after searching depth plies
+    void update_quiet_cutoff(bool white, int ply, int depth, const Move &move);
+};
+
+// Hands out the moves of a node one at a time in stages: TT move, winning and equal captures
+// and promotions, killers and the countermove, quiets by history, then losing captures.
+// Each stage is scored only when reached and picked by selection sort, so a cutoff skips the rest.
+class MovePicker
+{
+private:
+    enum class Stage
+    {
+        TTMove,
+        ScoreCaptures,
+        GoodCaptures,
+        Refutations,
+        ScoreQuiets,
+        Quiets,
+        BadCaptures,
+        Done
+    };
+
+    MoveList &moves;
+    const BoardRepresentation &board_representation;
+    const SearchHeuristics &heuristics;
+    Move tt_move;
+    int ply;
+    Stage stage;
+    int scores[MAX_MOVES];
+    std::size_t next;        // First move not handed out in the current region
+    std::size_t capture_end; // Captures and promotions sit in [start, capture_end), quiets after
+    std::size_t bad_capture; // Losing captures left for the last stage start here
+    int refutation_index;
+
+    bool is_tactical(const Move &move) const;
+    bool pick_best(std::size_t begin, std::size_t end, Move &move);
+    void swap_moves(std::size_t a, std::size_t b);
+
+public:
+    MovePicker(MoveList &moves,
+               const BoardRepresentation &board_representation,
+               const SearchHeuristics &heuristics,
+               const Move &tt_move,
+               int ply);
+
+    /// Store the next move to search in move, returns false once all moves were handed out
+    bool next_move(Move &move);
+};
+
+#endif // MOVE_PICKER_H
@@ -2,24 +2,26 @@
 #define MOVESTATE_H
 
 #include "square.h"
+#include <cstdint>
 
+// Everything make_move changes that undo_move cannot work out from the move itself
 struct MoveState
 {
-  bool white_can_castle_kingside;
-  bool white_can_castle_queenside;
-  bool black_can_castle_kingside;
-  bool black_can_castle_queenside;
-  Square en_passant_square; // Record the en passant square
-  int halfmove_clock;       // To restore 50-move rule count
-  int fullmove_number;
-  char piece_on_target_square; // Record any captured piece
-  bool white_to_move;
-
-  MoveState(bool w_ks, bool w_qs, bool b_ks, bool b_qs, Square ep_square, int halfmove, int fullmove, char captured, bool white_to_move)
-      : white_can_castle_kingside(w_ks), white_can_castle_queenside(w_qs),
-        black_can_castle_kingside(b_ks), black_can_castle_queenside(b_qs),
-        en_passant_square(ep_square), halfmove_clock(halfmove), fullmove_number(fullmove),
-        piece_on_target_square(captured), white_to_move(white_to_move) {}
+  bool white_can_castle_kingside = false;
+  bool white_can_castle_queenside = false;
+  bool black_can_castle_kingside = false;
+  bool black_can_castle_queenside = false;
+  Square en_passant_square = Square(-1, -1); // Record the en passant square
+  int halfmove_clock = 0;                    // To restore 50-move rule count
+  int fullmove_number = 0;
+  char piece_on_target_square = 'e';         // Record any captured piece
+  bool white_to_move = false;
+  std::uint64_t hash_key = 0;                // Position hash before the move
+  std::uint64_t pawn_key = 0;
+  int material[2] = {0, 0};                  // Incremental evaluation terms before the move
+  int midgame_score = 0;
+  int endgame_score = 0;
+  int plies_from_null = 0;
 };
 
-#endif // MOVESTATE_H
\ No newline at end of file
+#endif // MOVESTATE_H
@@ -0,0 +1,40 @@
+// pawn_hash_table.h
+#ifndef PAWN_HASH_TABLE_H
+#define PAWN_HASH_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/// Entries in a pawn hash table, a power of two
+static constexpr std::size_t PAWN_HASH_ENTRIES = 1 << 14;
+
+// Pawn structure score of one pawn placement, from white's point of view. An empty slot only matches
+// the key of a board without pawns, whose score is 0 as well.
+struct PawnHashEntry
+{
+    std::uint64_t key;
+    int score;
+
+    PawnHashEntry() : key(0), score(0) {}
+};
+
+// Caches the pawn structure evaluation by pawn key. Pawns move rarely, so most leaves of a search
+// share a placement with one already scored. Not thread-safe; every search thread keeps its own.
+// Scores never go stale, so nothing needs clearing between games.
+class PawnHashTable
+{
+private:
+    std::unique_ptr<PawnHashEntry[]> entries;
+
+public:
+    PawnHashTable();
+
+    /// Copy the score stored for a pawn key into score, returns false when it is not stored
+    bool probe(std::uint64_t pawn_key, int &score) const;
+
+    /// Store a score, replacing whatever shared its slot
+    void store(std::uint64_t pawn_key, int score);
+};
+
+#endif // PAWN_HASH_TABLE_H
@@ -0,0 +1,65 @@
+// perft.h
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "board_representation.h"
+#include "search_limits.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+/// Perft cache size used by go perft and the perft tool unless told otherwise
+const std::size_t PERFT_HASH_MB = 64;
+
+// Subtree node counts by position. The depth is mixed into the stored key, so one position
+// reached with different remaining depths takes separate slots. Always replaces on store.
+// Like the transposition table, the key is stored XORed with the count, so threads share it without locks.
+class PerftTable
+{
+private:
+    struct Entry
+    {
+        std::atomic<std::uint64_t> key;
+        std::atomic<std::uint64_t> nodes;
+
+        Entry() : key(0), nodes(0) {}
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    std::size_t mask;
+
+    static std::uint64_t entry_key(std::uint64_t hash_key, int depth);
+
+public:
+    /// Allocate the largest power of two number of entries that fits in megabytes
+    explicit PerftTable(std::size_t megabytes);
+
+    /// Copy the node count stored for a position and depth into nodes, returns false when it is not stored; thread-safe
+    bool probe(std::uint64_t hash_key, int depth, std::uint64_t &nodes) const;
+
+    /// Thread-safe
+    void store(std::uint64_t hash_key, int depth, std::uint64_t nodes);
+};
+
+/// Count the leaf nodes depth plies below the position. The last ply is counted without making
+/// its moves, and subtrees from depth 2 up are cached in table when one is given. Once limits is
+/// stopped the count returned is partial and nothing more is cached.
+std::uint64_t perft(BoardRepresentation &board,
+                    int depth,
+                    PerftTable *table = nullptr,
+                    const SearchLimits *limits = nullptr);
+
+/// Perft that writes the node count below every root move ("e2e4: 20"), then the total, time and
+/// nodes per second. With more than one thread the subtrees two plies down are shared out among
+/// workers, each on its own copy of the board; the output does not depend on the thread count.
+/// Once limits is stopped the count ends early, and only root moves counted in full are listed.
+std::uint64_t perft_divide(BoardRepresentation &board,
+                           int depth,
+                           std::ostream &out,
+                           PerftTable *table = nullptr,
+                           int threads = 1,
+                           const SearchLimits *limits = nullptr);
+
+#endif // PERFT_H
@@ -1,7 +1,7 @@
 #ifndef PIECE_TABLES_H
 #define PIECE_TABLES_H
 
-const int pawn_piece_square_table[8][8] = {0, 0, 0, 0, 0, 0, 0, 0,
+constexpr int pawn_piece_square_table[8][8] = {0, 0, 0, 0, 0, 0, 0, 0,
                                            50, 50, 50, 50, 50, 50, 50, 50,
                                            10, 10, 20, 30, 30, 20, 10, 10,
                                            5, 5, 10, 25, 25, 10, 5, 5,
@@ -10,7 +10,7 @@ const int pawn_piece_square_table[8][8] = {0, 0, 0, 0, 0, 0, 0, 0,
                                            5, 10, 10, -20, -20, 10, 10, 5,
                                            0, 0, 0, 0, 0, 0, 0, 0};
 
-const int knight_piece_square_table[8][8] = {-50, -40, -30, -30, -30, -30, -40, -50,
+constexpr int knight_piece_square_table[8][8] = {-50, -40, -30, -30, -30, -30, -40, -50,
                                              -40, -20, 0, 0, 0, 0, -20, -40,
                                              -30, 0, 10, 15, 15, 10, 0, -30,
                                              -30, 5, 15, 20, 20, 15, 5, -30,
@@ -19,7 +19,7 @@ const int knight_piece_square_table[8][8] = {-50, -40, -30, -30, -30, -30, -40,
                                              -40, -20, 0, 5, 5, 0, -20, -40,
                                              -50, -40, -30, -30, -30, -30, -40, -50};
 
-const int bishop_piece_square_table[8][8] = {-20, -10, -10, -10, -10, -10, -10, -20,
+constexpr int bishop_piece_square_table[8][8] = {-20, -10, -10, -10, -10, -10, -10, -20,
                                              -10, 0, 0, 0, 0, 0, 0, -10,
                                              -10, 0, 5, 10, 10, 5, 0, -10,
                                              -10, 5, 5, 10, 10, 5, 5, -10,
@@ -28,7 +28,7 @@ const int bishop_piece_square_table[8][8] = {-20, -10, -10, -10, -10, -10, -10,
                                              -10, 5, 0, 0, 0, 0, 5, -10,
                                              -20, -10, -10, -10, -10, -10, -10, -20};
 
-const int rook_piece_square_table[8][8] = {0, 0, 0, 0, 0, 0, 0, 0,
+constexpr int rook_piece_square_table[8][8] = {0, 0, 0, 0, 0, 0, 0, 0,
                                            5, 10, 10, 10, 10, 10, 10, 5,
                                            -5, 0, 0, 0, 0, 0, 0, -5,
                                            -5, 0, 0, 0, 0, 0, 0, -5,
@@ -37,7 +37,7 @@ const int rook_piece_square_table[8][8] = {0, 0, 0, 0, 0, 0, 0, 0,
                                            -5, 0, 0, 0, 0, 0, 0, -5,
                                            0, 0, 0, 5, 5, 0, 0, 0};
 
-const int queen_piece_square_table[8][8] = {-20, -10, -10, -5, -5, -10, -10, -20,
+constexpr int queen_piece_square_table[8][8] = {-20, -10, -10, -5, -5, -10, -10, -20,
                                             -10, 0, 0, 0, 0, 0, 0, -10,
                                             -10, 0, 5, 5, 5, 5, 0, -10,
                                             -5, 0, 5, 5, 5, 5, 0, -5,
@@ -46,7 +46,7 @@ const int queen_piece_square_table[8][8] = {-20, -10, -10, -5, -5, -10, -10, -20
                                             -10, 0, 5, 0, 0, 0, 0, -10,
                                             -20, -10, -10, -5, -5, -10, -10, -20};
 
-const int king_piece_square_table[8][8] = {-30, -40, -40, -50, -50, -40, -40, -30,
+constexpr int king_piece_square_table[8][8] = {-30, -40, -40, -50, -50, -40, -40, -30,
                                            -30, -40, -40, -50, -50, -40, -40, -30,
                                            -30, -40, -40, -50, -50, -40, -40, -30,
                                            -30, -40, -40, -50, -50, -40, -40, -30,
@@ -55,7 +55,7 @@ const int king_piece_square_table[8][8] = {-30, -40, -40, -50, -50, -40, -40, -3
                                            20, 20, -10, -10, -10, -10, 20, 20,
                                            20, 30, 10, 0, 0, 10, 30, 20};
 
-const int king_endgame_piece_square_table[8][8] = {-50, -40, -30, -20, -20, -30, -40, -50,
+constexpr int king_endgame_piece_square_table[8][8] = {-50, -40, -30, -20, -20, -30, -40, -50,
                                                    -30, -20, -10, 0, 0, -10, -20, -30,
                                                    -30, -10, 20, 30, 30, 20, -10, -30,
                                                    -30, -10, 30, 40, 40, 30, -10, -30,
@@ -64,4 +64,45 @@ const int king_endgame_piece_square_table[8][8] = {-50, -40, -30, -20, -20, -30,
                                                    -30, -30, 0, 0, 0, 0, -30, -30,
                                                    -50, -30, -30, -30, -30, -30, -30, -50};
 
+/// Material value by piece type (piece_to_index % 6), kings are not counted
+constexpr int PIECE_TYPE_VALUES[6] = {100, 300, 300, 500, 900, 0};
+
+// Material plus piece-square value of every piece on every square, indexed by piece_to_index and
+// square (rank * 8 + file). Black values are negated so the scores read from white's side.
+struct PieceSquareScores
+{
+    int midgame[12][64];
+    int endgame[12][64];
+};
+
+constexpr PieceSquareScores build_piece_square_scores()
+{
+    const int(*midgame_tables[6])[8] = {pawn_piece_square_table, knight_piece_square_table,
+                                        bishop_piece_square_table, rook_piece_square_table,
+                                        queen_piece_square_table, king_piece_square_table};
+    const int(*endgame_tables[6])[8] = {pawn_piece_square_table, knight_piece_square_table,
+                                        bishop_piece_square_table, rook_piece_square_table,
+                                        queen_piece_square_table, king_endgame_piece_square_table};
+
+    PieceSquareScores scores{};
+    for (int piece_index = 0; piece_index < 12; ++piece_index)
+    {
+        bool white = piece_index < 6;
+        int type = piece_index % 6;
+        for (int square = 0; square < 64; ++square)
+        {
+            // Tables are written from white's side with the eighth rank first
+            int rank = white ? 7 - square / 8 : square / 8;
+            int file = square % 8;
+            int sign = white ? 1 : -1;
+
+            scores.midgame[piece_index][square] = sign * (PIECE_TYPE_VALUES[type] + midgame_tables[type][rank][file]);
+            scores.endgame[piece_index][square] = sign * (PIECE_TYPE_VALUES[type] + endgame_tables[type][rank][file]);
+        }
+    }
+    return scores;
+}
+
+constexpr PieceSquareScores PIECE_SQUARE_SCORES = build_piece_square_scores();
+
 #endif // PIECE_TABLES_H
\ No newline at end of file
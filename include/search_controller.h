@@ -0,0 +1,85 @@
+#ifndef SEARCH_CONTROLLER_H
+#define SEARCH_CONTROLLER_H
+
+#include "evaluation.h"
+#include "perft.h"
+#include "bench.h"
+#include "transposition_table.h"
+#include "search_limits.h"
+#include "logging.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+// Runs one search at a time on its own thread so the UCI loop keeps reading commands.
+// The search thread prints "bestmove" itself when it finishes; the loop only steers it through the limits.
+class SearchController
+{
+private:
+    std::ostream &out;
+    std::mutex output_mutex; // keeps lines from the UCI loop and the search thread whole
+    std::thread search_thread;
+    SearchLimits limits;
+    int threads; // Lazy SMP search threads, including the main one
+    std::atomic<bool> report_result; // cleared when a search is abandoned without a bestmove
+
+    /// Run task on the search thread once the previous one has been abandoned
+    void launch(std::function<void()> task, bool hold_result = false);
+
+    /// Launch a search that reports its bestmove unless abandoned. A held result waits for "stop"
+    /// or "ponderhit", since UCI forbids a bestmove before either in infinite and ponder mode.
+    void start(std::function<Evaluation()> run, bool hold_result = false);
+
+public:
+    explicit SearchController(std::ostream &out);
+    ~SearchController();
+
+    SearchController(const SearchController &) = delete;
+    SearchController &operator=(const SearchController &) = delete;
+
+    /// Number of threads later searches run on; takes effect from the next "go"
+    void set_threads(int count);
+    int thread_count() const { return threads; }
+
+    /// Write one line to the GUI and log it; thread-safe
+    void send(const std::string &line);
+
+    /// Search with a clock-based budget, or forced_time milliseconds when it is not negative
+    void go(const BoardRepresentation &board_representation,
+            TranspositionTable &transposition_table,
+            int wtime, int btime, int winc, int binc, int forced_time);
+
+    /// Search to a fixed depth, clamped to MAX_SEARCH_DEPTH, or until "stop"
+    void go_depth(const BoardRepresentation &board_representation,
+                  TranspositionTable &transposition_table,
+                  int depth);
+
+    /// Search until "stop"
+    void go_infinite(const BoardRepresentation &board_representation,
+                     TranspositionTable &transposition_table);
+
+    /// Search on the opponent's time until "ponderhit" starts the clock or "stop" ends it
+    void go_ponder(const BoardRepresentation &board_representation,
+                   TranspositionTable &transposition_table,
+                   int wtime, int btime, int winc, int binc, int forced_time);
+
+    /// Perft divide of the position on the search thread; "stop" ends it early with the root moves completed so far
+    void go_perft(const BoardRepresentation &board_representation, int depth);
+
+    /// Bench on the search thread; "stop" ends it after the current position
+    void go_bench(int depth);
+
+    /// The expected move was played; the ponder search becomes a timed one
+    void on_ponder_hit();
+
+    /// End the running search now and wait for its bestmove
+    void stop();
+
+    /// End the running search without reporting a bestmove, e.g. before a new position
+    void abort();
+};
+
+#endif // SEARCH_CONTROLLER_H
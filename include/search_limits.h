@@ -0,0 +1,114 @@
+#ifndef SEARCH_LIMITS_H
+#define SEARCH_LIMITS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+/// Nodes searched between two reads of the clock
+const std::uint64_t NODES_BETWEEN_CLOCK_CHECKS = 1024;
+
+// Everything that can end a search. The search loop only reads the relaxed stop flag; the
+// deadline and node limit are checked as nodes are counted and raise that flag once exceeded.
+class SearchLimits
+{
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr Clock::rep NO_DEADLINE = std::numeric_limits<Clock::rep>::max();
+
+    std::atomic<bool> stop_flag;
+    std::atomic<bool> result_held; // Infinite and ponder searches keep their bestmove until stop or ponderhit
+    std::atomic<Clock::rep> deadline; // Clock ticks since epoch, may be set from another thread on ponderhit
+    std::chrono::milliseconds time_budget;
+    std::uint64_t nodes;
+
+public:
+    int max_depth;           // 0 for no limit
+    std::uint64_t max_nodes; // 0 for no limit
+
+    SearchLimits()
+        : stop_flag(false), result_held(false), deadline(NO_DEADLINE), time_budget(0), nodes(0), max_depth(0), max_nodes(0) {}
+
+    SearchLimits(const SearchLimits &) = delete;
+    SearchLimits &operator=(const SearchLimits &) = delete;
+
+    /// Clear all limits before reusing the object for a new search; not safe while a search is running
+    void reset()
+    {
+        stop_flag.store(false, std::memory_order_relaxed);
+        result_held.store(false);
+        deadline.store(NO_DEADLINE, std::memory_order_relaxed);
+        time_budget = std::chrono::milliseconds(0);
+        nodes = 0;
+        max_depth = 0;
+        max_nodes = 0;
+    }
+
+    /// Time the search may take once the clock is started
+    void set_time_budget(std::chrono::milliseconds budget) { time_budget = budget; }
+    std::chrono::milliseconds get_time_budget() const { return time_budget; }
+
+    /// Start spending the time budget, e.g. on ponderhit; thread-safe
+    void start_clock()
+    {
+        auto cutoff = Clock::now() + std::chrono::duration_cast<Clock::duration>(time_budget);
+        deadline.store(cutoff.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    /// Ask the search to end as soon as possible, releasing a held result; thread-safe
+    void stop()
+    {
+        stop_flag.store(true, std::memory_order_relaxed);
+        release_result();
+    }
+
+    /// Keep the result of the coming search from being reported until release_result or stop
+    void hold_result() { result_held.store(true); }
+
+    /// Let a held result be reported, e.g. on ponderhit; thread-safe
+    void release_result()
+    {
+        result_held.store(false);
+        result_held.notify_all();
+    }
+
+    /// Block until the result may be reported
+    void wait_for_release() const
+    {
+        while (result_held.load())
+        {
+            result_held.wait(true);
+        }
+    }
+
+    bool stopped() const { return stop_flag.load(std::memory_order_relaxed); }
+
+    /// Raise the stop flag if the deadline has passed
+    void check_clock()
+    {
+        Clock::rep cutoff = deadline.load(std::memory_order_relaxed);
+        if (cutoff != NO_DEADLINE && Clock::now().time_since_epoch().count() >= cutoff)
+        {
+            stop();
+        }
+    }
+
+    /// Count a searched node, reading the clock only every NODES_BETWEEN_CLOCK_CHECKS nodes
+    void count_node()
+    {
+        ++nodes;
+        if (nodes == max_nodes)
+        {
+            stop();
+        }
+        if (nodes % NODES_BETWEEN_CLOCK_CHECKS == 0)
+        {
+            check_clock();
+        }
+    }
+
+    std::uint64_t nodes_searched() const { return nodes; }
+};
+
+#endif // SEARCH_LIMITS_H
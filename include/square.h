@@ -57,6 +57,12 @@ struct Square
         return std::string(1, file_char) + std::to_string(rank_num);
     }
 
+    // Index of the square in a bitboard
+    int to_index() const
+    {
+        return rank * 8 + file;
+    }
+
     bool is_between(const Square &square_a, const Square &square_b) const;
 };
 
@@ -2,33 +2,42 @@
 #ifndef TRANSPOSITION_TABLE_H
 #define TRANSPOSITION_TABLE_H
 
-#include <unordered_map>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <stdexcept>
-#include <shared_mutex> // C++17 shared_mutex
 #include "move.h"
 #include "logging.h"
 #include "zobrist_values.h"
 
-/// Minimum depth at which we store positions
+/// Minimum depth at which the main search stores positions
 static constexpr int MIN_TRANSPOSITION_DEPTH = 2;
-/// Maximum "age difference" after which old TT entries are pruned
+/// Depth recorded for quiescence search results, shallower than any main search entry
+static constexpr int QUIESCENCE_DEPTH = 0;
+/// Searches after which an entry is stale and overwritten before any other
 static constexpr int OLDEST_AGE_TO_HOLD = 3;
+/// Table size in megabytes when no Hash option is given
+static constexpr std::size_t DEFAULT_HASH_MB = 16;
+static constexpr std::size_t MAX_HASH_MB = 1024;
+/// Entries sharing one cache line
+static constexpr int BUCKET_SIZE = 4;
 
-enum class EntryType
+enum class EntryType : std::uint8_t
 {
     PV,
     Beta,
     Alpha
 };
 
+// Unpacked copy of a stored entry handed out by a probe
 struct TranspositionRow
 {
-    int eval;
-    int depth;
-    int age;
+    std::int32_t eval;
     Move best_move;
     Move best_response;
+    std::int16_t depth;
+    std::uint8_t age;
     EntryType entry_type;
 
     TranspositionRow();
@@ -40,15 +49,42 @@ struct TranspositionRow
                      int age);
 };
 
+// One slot of a bucket. The key is stored XORed with the data so a probe racing a write on
+// another thread sees a key mismatch instead of a torn entry, letting readers and writers skip locks.
+// Data layout: bits 0-15 best move, 16-31 best response, 32-52 eval, 53-58 depth,
+// 59-60 entry type, 61-63 age
+struct TranspositionEntry
+{
+    std::atomic<std::uint64_t> key;
+    std::atomic<std::uint64_t> data;
+
+    TranspositionEntry() : key(0), data(0) {}
+};
+
+struct alignas(64) TranspositionBucket
+{
+    TranspositionEntry entries[BUCKET_SIZE];
+
+    TranspositionBucket() : entries() {}
+};
+
 class TranspositionTable
 {
 private:
-    std::unordered_map<std::uint64_t, TranspositionRow> table;
-    int current_age;
-    mutable std::shared_mutex mutex_; // protects both table and current_age
+    std::unique_ptr<TranspositionBucket[]> buckets;
+    std::size_t bucket_count; // Power of two so the hash can be masked into an index
+    std::atomic<int> current_age;
+
+    TranspositionBucket &bucket_for(std::uint64_t hash) const
+    {
+        return buckets[hash & (bucket_count - 1)];
+    }
 
 public:
-    TranspositionTable();
+    explicit TranspositionTable(std::size_t megabytes = DEFAULT_HASH_MB);
+
+    /// Reallocate with the largest power of two number of buckets fitting in the given size, dropping all entries
+    void resize(std::size_t megabytes);
 
     /// Insert or update; thread-safe
     void insert(std::uint64_t hash,
@@ -58,17 +94,17 @@ public:
                 const Move &best_response,
                 EntryType entry_type);
 
-    /// Retrieve (and refresh age); thread-safe
-    const TranspositionRow *get(std::uint64_t hash);
+    /// Copy the entry for a hash into row, returns false when it is not stored; thread-safe
+    bool get(std::uint64_t hash, TranspositionRow &row) const;
 
-    /// Clear all entries; thread-safe
+    /// Clear all entries; not safe while a search is running
     void reset_table();
 
-    /// Bump the global age; thread-safe
+    /// Bump the global age so entries from earlier searches become replaceable; thread-safe
     void age_table();
 
-    /// Prune old entries; thread-safe
-    void maintain_table();
+    /// Size of the table in bytes
+    std::size_t size_in_bytes() const { return bucket_count * sizeof(TranspositionBucket); }
 };
 
 #endif // TRANSPOSITION_TABLE_H
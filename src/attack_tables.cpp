@@ -0,0 +1,201 @@
+#include "attack_tables.h"
+#include <stdexcept>
+
+u64 BETWEEN[64][64];
+u64 LINE[64][64];
+
+u64 KNIGHT_ATTACKS[64];
+u64 KING_ATTACKS[64];
+u64 PAWN_ATTACKS[2][64];
+
+Magic ROOK_MAGICS[64];
+Magic BISHOP_MAGICS[64];
+u64 ROOK_ATTACK_TABLE[102400];
+u64 BISHOP_ATTACK_TABLE[5248];
+
+namespace
+{
+    constexpr int ROOK_DIRECTIONS[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+    constexpr int BISHOP_DIRECTIONS[4][2] = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+    constexpr int KNIGHT_OFFSETS[8][2] = {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}};
+    constexpr int KING_OFFSETS[8][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+
+    // Multipliers found offline with a sparse random search, each gives a collision free index per square
+    constexpr u64 ROOK_MAGIC_NUMBERS[64] = {
+        0x2480009220844008ULL, 0x8040100020004001ULL, 0x0100081020004500ULL, 0xA2000A00200E4006ULL,
+        0x0200082004100200ULL, 0x0280012400020080ULL, 0x2080420001000080ULL, 0x2200009200204104ULL,
+        0x0420800080204002ULL, 0x4000808020004000ULL, 0x0802801000802000ULL, 0x0802001200204408ULL,
+        0x0404800800040080ULL, 0x00680108A0400410ULL, 0x0091000401008200ULL, 0x0441001100125582ULL,
+        0x0200208000804004ULL, 0x0010004000402000ULL, 0x0040808020001002ULL, 0x0028090010010021ULL,
+        0x0008004004020041ULL, 0x8025010002880400ULL, 0x02022C0008061003ULL, 0x0901020004008041ULL,
+        0x0080084840002000ULL, 0x54D0004040102008ULL, 0x0000220200104084ULL, 0x0001180180100080ULL,
+        0x0000080080800400ULL, 0x0420020080800400ULL, 0x0088220400013008ULL, 0x2200008200006114ULL,
+        0x0020400028800080ULL, 0x0090002001400040ULL, 0x4000110445002000ULL, 0x0080082042001200ULL,
+        0x010A080082800400ULL, 0x2104000802020010ULL, 0x0C80582114000250ULL, 0x1300090082000864ULL,
+        0x488001402000C000ULL, 0x0000820100420024ULL, 0x8401002000410010ULL, 0x6000080010008080ULL,
+        0x8010040008008080ULL, 0x2402000204008080ULL, 0x220402D001040008ULL, 0x020000408D060024ULL,
+        0x0080044000200840ULL, 0x1404401000200840ULL, 0x01048020104A0200ULL, 0x040441A008120200ULL,
+        0x0204800802040080ULL, 0x2001000400024900ULL, 0x0040821008410400ULL, 0x000480010006D880ULL,
+        0x0C4100A013800441ULL, 0x0000288100400015ULL, 0x0286200010400B01ULL, 0x2000842090010009ULL,
+        0x4001005008004205ULL, 0x040A000841841022ULL, 0x0400010210080084ULL, 0x2098890044088022ULL,};
+
+    constexpr u64 BISHOP_MAGIC_NUMBERS[64] = {
+        0x81080204004C010AULL, 0x0010114800828000ULL, 0x0488008112024030ULL, 0x8044040090010020ULL,
+        0x040C504080000420ULL, 0x2C02020222201510ULL, 0x0004842420041009ULL, 0x000014040C240421ULL,
+        0x7400040408084100ULL, 0x1002200242120020ULL, 0x0000120086020000ULL, 0x0234944100208050ULL,
+        0x00A0020210801004ULL, 0x10C0013008200202ULL, 0x0081A20A84144041ULL, 0x0880120186088A00ULL,
+        0x0060024088514100ULL, 0x0060002428D08100ULL, 0x000200E404001200ULL, 0x400402D844000811ULL,
+        0x0004900404201101ULL, 0x1002000420902842ULL, 0x0802009101212104ULL, 0x0008880300980100ULL,
+        0x2408400008029840ULL, 0x0002083012980822ULL, 0x0008020404002200ULL, 0x400C004014010580ULL,
+        0x2884040010410046ULL, 0x0008011002011080ULL, 0x0828104542064215ULL, 0x000042004101011AULL,
+        0x0010022205084804ULL, 0x5201440202200800ULL, 0x0002844102301405ULL, 0x0C42020082080080ULL,
+        0x4040008200410104ULL, 0x1810208200002218ULL, 0x0001140090440200ULL, 0x5602540221210080ULL,
+        0x01820220A0084410ULL, 0x8000A08410032000ULL, 0x01800A0802011400ULL, 0x0010004010420200ULL,
+        0x0000401102100102ULL, 0x0201160614100200ULL, 0x0810418200830400ULL, 0x4901014404808500ULL,
+        0x4042109008089204ULL, 0x0002004208058002ULL, 0x1000030401044180ULL, 0x000C200820884000ULL,
+        0x04008011E0220000ULL, 0x0000411002008000ULL, 0xD004200461420218ULL, 0x00020248020082B0ULL,
+        0x5080404210412000ULL, 0x0800002401041010ULL, 0x0000000044041140ULL, 0x4802800500208804ULL,
+        0x2001005420604101ULL, 0x0400000808100420ULL, 0x0201204444080040ULL, 0xA9144C4082140100ULL,};
+
+    bool on_board(int rank, int file)
+    {
+        return rank >= 0 && rank <= 7 && file >= 0 && file <= 7;
+    }
+
+    u64 square_bit(int rank, int file)
+    {
+        return 1ULL << (rank * 8 + file);
+    }
+
+    u64 leaper_attacks(int square, const int offsets[8][2])
+    {
+        u64 attacks = 0ULL;
+        for (int i = 0; i < 8; ++i)
+        {
+            int rank = square / 8 + offsets[i][0];
+            int file = square % 8 + offsets[i][1];
+            if (on_board(rank, file))
+            {
+                attacks |= square_bit(rank, file);
+            }
+        }
+        return attacks;
+    }
+
+    // Walk the rays square by square (only used to fill the tables)
+    u64 sliding_attacks(int square, u64 occupied, const int directions[4][2])
+    {
+        u64 attacks = 0ULL;
+        for (int i = 0; i < 4; ++i)
+        {
+            int rank = square / 8 + directions[i][0];
+            int file = square % 8 + directions[i][1];
+            while (on_board(rank, file))
+            {
+                attacks |= square_bit(rank, file);
+                if (occupied & square_bit(rank, file))
+                {
+                    break; // Blocked by a piece of either colour
+                }
+                rank += directions[i][0];
+                file += directions[i][1];
+            }
+        }
+        return attacks;
+    }
+
+    // Fill the attack table of one slider type
+    void init_sliding_table(Magic magics[64], u64 *table, const u64 magic_numbers[64], const int directions[4][2])
+    {
+        unsigned offset = 0;
+
+        for (int square = 0; square < 64; ++square)
+        {
+            Magic &magic = magics[square];
+
+            // Edge squares never block a ray further, so leave them out of the relevant occupancy
+            u64 rank_edges = (RANK_1 | RANK_8) & ~(RANK_1 << (8 * (square / 8)));
+            u64 file_edges = (FILE_A | FILE_H) & ~(FILE_A << (square % 8));
+            magic.mask = sliding_attacks(square, 0ULL, directions) & ~(rank_edges | file_edges);
+            magic.magic = magic_numbers[square];
+            magic.shift = static_cast<unsigned>(64 - count_bits(magic.mask));
+            magic.offset = offset;
+
+            // Enumerate every subset of the mask (Carry-Rippler) and store its attack set
+            unsigned size = 0;
+            u64 subset = 0ULL;
+            do
+            {
+                unsigned index = magic.index(subset);
+                u64 attacks = sliding_attacks(square, subset, directions);
+
+                if (table[index] != 0ULL && table[index] != attacks)
+                {
+                    throw std::runtime_error("Magic number collision while building attack tables.");
+                }
+                table[index] = attacks;
+
+                ++size;
+                subset = (subset - magic.mask) & magic.mask;
+            } while (subset);
+
+            offset += size;
+        }
+    }
+}
+
+void init_attack_tables()
+{
+    static bool initialised = false;
+    if (initialised)
+    {
+        return;
+    }
+
+    for (int square = 0; square < 64; ++square)
+    {
+        KNIGHT_ATTACKS[square] = leaper_attacks(square, KNIGHT_OFFSETS);
+        KING_ATTACKS[square] = leaper_attacks(square, KING_OFFSETS);
+
+        int rank = square / 8;
+        int file = square % 8;
+        PAWN_ATTACKS[0][square] = PAWN_ATTACKS[1][square] = 0ULL;
+        for (int delta_file = -1; delta_file <= 1; delta_file += 2)
+        {
+            if (on_board(rank + 1, file + delta_file))
+            {
+                PAWN_ATTACKS[0][square] |= square_bit(rank + 1, file + delta_file);
+            }
+            if (on_board(rank - 1, file + delta_file))
+            {
+                PAWN_ATTACKS[1][square] |= square_bit(rank - 1, file + delta_file);
+            }
+        }
+    }
+
+    init_sliding_table(ROOK_MAGICS, ROOK_ATTACK_TABLE, ROOK_MAGIC_NUMBERS, ROOK_DIRECTIONS);
+    init_sliding_table(BISHOP_MAGICS, BISHOP_ATTACK_TABLE, BISHOP_MAGIC_NUMBERS, BISHOP_DIRECTIONS);
+
+    for (int square_a = 0; square_a < 64; ++square_a)
+    {
+        for (int square_b = 0; square_b < 64; ++square_b)
+        {
+            u64 bit_a = 1ULL << square_a;
+            u64 bit_b = 1ULL << square_b;
+            BETWEEN[square_a][square_b] = LINE[square_a][square_b] = 0ULL;
+
+            if (rook_attacks(square_a, 0ULL) & bit_b)
+            {
+                LINE[square_a][square_b] = (rook_attacks(square_a, 0ULL) & rook_attacks(square_b, 0ULL)) | bit_a | bit_b;
+                BETWEEN[square_a][square_b] = rook_attacks(square_a, bit_b) & rook_attacks(square_b, bit_a);
+            }
+            else if (bishop_attacks(square_a, 0ULL) & bit_b)
+            {
+                LINE[square_a][square_b] = (bishop_attacks(square_a, 0ULL) & bishop_attacks(square_b, 0ULL)) | bit_a | bit_b;
+                BETWEEN[square_a][square_b] = bishop_attacks(square_a, bit_b) & bishop_attacks(square_b, bit_a);
+            }
+        }
+    }
+
+    initialised = true;
+}
@@ -2,6 +2,9 @@
 // #include <ncurses.h>
 #include <iostream>
 #include <sstream>
+#include <cassert>
+#include <stdexcept>
+#include <algorithm>
 #include <vector>
 #include <locale.h>
 
@@ -15,15 +18,22 @@ BoardRepresentation::BoardRepresentation()
       en_passant_square(-1, -1), // Assuming Square has a constructor that accepts two integers
       halfmove_clock(0),
       fullmove_number(0),
-      non_empty_squares(),
+      piece_bitboards(),
+      white_pieces(0),
+      black_pieces(0),
+      occupied(0),
+      hash_key(0),
+      pawn_key(0),
+      material(),
+      midgame_score(0),
+      endgame_score(0),
       is_in_check(false),
-      threefold_map(),
-      move_stack()
+      plies_from_null(0),
+      move_history(),
+      history_size(0)
 {
     // Initialize using the standard starting position
     input_fen_position(START_POS);
-    u_int64_t hash_key = zobrist_hash();
-    threefold_map.increment(hash_key);
 }
 
 // Constructor with FEN string
@@ -36,15 +46,22 @@ BoardRepresentation::BoardRepresentation(const std::string &fen)
       en_passant_square(-1, -1),
       halfmove_clock(0),
       fullmove_number(0),
-      non_empty_squares(),
+      piece_bitboards(),
+      white_pieces(0),
+      black_pieces(0),
+      occupied(0),
+      hash_key(0),
+      pawn_key(0),
+      material(),
+      midgame_score(0),
+      endgame_score(0),
       is_in_check(false),
-      threefold_map(),
-      move_stack()
+      plies_from_null(0),
+      move_history(),
+      history_size(0)
 {
     // Initialize using the provided FEN string
     input_fen_position(fen);
-    u_int64_t hash_key = zobrist_hash();
-    threefold_map.increment(hash_key);
 }
 
 // Constructor with only moves
@@ -57,16 +74,23 @@ BoardRepresentation::BoardRepresentation(const std::vector<std::string> &moves)
       en_passant_square(-1, -1),
       halfmove_clock(0),
       fullmove_number(0),
-      non_empty_squares(),
+      piece_bitboards(),
+      white_pieces(0),
+      black_pieces(0),
+      occupied(0),
+      hash_key(0),
+      pawn_key(0),
+      material(),
+      midgame_score(0),
+      endgame_score(0),
       is_in_check(false),
-      threefold_map(),
-      move_stack()
+      plies_from_null(0),
+      move_history(),
+      history_size(0)
 {
     // Initialize using the provided FEN string
     input_fen_position(START_POS);
 
-    u_int64_t hash_key = zobrist_hash();
-    threefold_map.increment(hash_key);
 
     // play moves
     for (const std::string &move : moves)
@@ -85,16 +109,23 @@ BoardRepresentation::BoardRepresentation(const std::string &fen, const std::vect
       en_passant_square(-1, -1),
       halfmove_clock(0),
       fullmove_number(0),
-      non_empty_squares(),
+      piece_bitboards(),
+      white_pieces(0),
+      black_pieces(0),
+      occupied(0),
+      hash_key(0),
+      pawn_key(0),
+      material(),
+      midgame_score(0),
+      endgame_score(0),
       is_in_check(false),
-      threefold_map(),
-      move_stack()
+      plies_from_null(0),
+      move_history(),
+      history_size(0)
 {
     // Initialize using the provided FEN string
     input_fen_position(fen);
 
-    u_int64_t hash_key = zobrist_hash();
-    threefold_map.increment(hash_key);
 
     // play moves
     for (const std::string &move : moves)
@@ -177,26 +208,95 @@ void BoardRepresentation::input_fen_position(const std::string &fen)
     halfmove_clock = std::stoi(half_move_clock_str);
     fullmove_number = std::stoi(full_move_number_str);
 
-    set_non_empty_squares();
+    set_bitboards();
+    hash_key = compute_zobrist_hash();
+    history_size = 0; // Nothing to undo in a freshly loaded position
+    plies_from_null = 0;
 }
 
-void BoardRepresentation::set_non_empty_squares()
+void BoardRepresentation::set_bitboards()
 {
     // start from empty
-    non_empty_squares.clear();
+    for (u64 &bitboard : piece_bitboards)
+    {
+        bitboard = 0ULL;
+    }
+    white_pieces = black_pieces = occupied = 0ULL;
+    pawn_key = 0;
+    material[0] = material[1] = 0;
+    midgame_score = endgame_score = 0;
 
     for (int8_t i = 0; i < 8; ++i)
     {
         for (int8_t j = 0; j < 8; ++j)
         {
-            if (board[i][j] != 'e')
+            char piece = board[i][j];
+            if (piece != 'e')
             {
-                non_empty_squares.insert(Square(i, j));
+                board[i][j] = 'e';
+                place_piece(piece, i, j);
             }
         }
     }
 }
 
+void BoardRepresentation::place_piece(char piece, int8_t rank, int8_t file)
+{
+    int piece_index = set_square(piece, rank, file);
+    hash_key ^= ZOBRIST_PIECE[piece_index][rank * 8 + file];
+    update_scores(piece_index, rank * 8 + file, 1);
+}
+
+int BoardRepresentation::set_square(char piece, int8_t rank, int8_t file)
+{
+    int piece_index = piece_to_index(piece);
+    u64 mask = 1ULL << (rank * 8 + file);
+
+    board[rank][file] = piece;
+    piece_bitboards[piece_index] |= mask;
+    if (is_white_piece(piece))
+    {
+        white_pieces |= mask;
+    }
+    else
+    {
+        black_pieces |= mask;
+    }
+    occupied |= mask;
+    return piece_index;
+}
+
+void BoardRepresentation::update_scores(int piece_index, int square, int sign)
+{
+    if (piece_index % 6 == 0)
+    {
+        pawn_key ^= ZOBRIST_PIECE[piece_index][square];
+    }
+    material[(piece_index < 6) ? 0 : 1] += sign * PIECE_TYPE_VALUES[piece_index % 6];
+    midgame_score += sign * PIECE_SQUARE_SCORES.midgame[piece_index][square];
+    endgame_score += sign * PIECE_SQUARE_SCORES.endgame[piece_index][square];
+}
+
+void BoardRepresentation::remove_piece(int8_t rank, int8_t file)
+{
+    int piece_index = clear_square(rank, file);
+    hash_key ^= ZOBRIST_PIECE[piece_index][rank * 8 + file];
+    update_scores(piece_index, rank * 8 + file, -1);
+}
+
+int BoardRepresentation::clear_square(int8_t rank, int8_t file)
+{
+    int piece_index = piece_to_index(board[rank][file]);
+    u64 mask = ~(1ULL << (rank * 8 + file));
+
+    board[rank][file] = 'e';
+    piece_bitboards[piece_index] &= mask;
+    white_pieces &= mask;
+    black_pieces &= mask;
+    occupied &= mask;
+    return piece_index;
+}
+
 std::string BoardRepresentation::output_fen_position() const
 {
     std::stringstream fen;
@@ -276,170 +376,168 @@ std::string BoardRepresentation::output_fen_position() const
     return fen.str();
 }
 
-// Make move and store positions
+void BoardRepresentation::save_state(char captured_piece)
+{
+    assert(history_size < move_history.size());
+    MoveState &state = move_history[history_size++];
+
+    state.white_can_castle_kingside = white_can_castle_kingside;
+    state.white_can_castle_queenside = white_can_castle_queenside;
+    state.black_can_castle_kingside = black_can_castle_kingside;
+    state.black_can_castle_queenside = black_can_castle_queenside;
+    state.en_passant_square = en_passant_square;
+    state.halfmove_clock = halfmove_clock;
+    state.fullmove_number = fullmove_number;
+    state.piece_on_target_square = captured_piece;
+    state.white_to_move = white_to_move;
+    state.hash_key = hash_key;
+    state.pawn_key = pawn_key;
+    state.material[0] = material[0];
+    state.material[1] = material[1];
+    state.midgame_score = midgame_score;
+    state.endgame_score = endgame_score;
+    state.plies_from_null = plies_from_null;
+}
+
+bool BoardRepresentation::is_repetition(int plies_from_root) const
+{
+    // Captures, pawn moves and null moves cannot be undone, so no earlier position can match
+    int lookback = std::min(halfmove_clock, plies_from_null);
+    int occurrences = 0;
+
+    // The same side is to move only every second ply, and a position needs at least four plies to come back
+    for (int distance = 4; distance <= lookback; distance += 2)
+    {
+        if (move_history[history_size - static_cast<std::size_t>(distance)].hash_key == hash_key)
+        {
+            if (distance < plies_from_root || ++occurrences == 2)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Make a game move, it stays in the move history for repetition checks
 void BoardRepresentation::make_move_literal(const std::string &move)
 {
+    // Leave room for the search on top of the game. Positions from before the last capture or pawn move
+    // can never come back, so a long game only keeps the history since then, up to half the array.
+    // Game moves are never undone, so dropping the older states loses nothing
+    if (history_size >= MAX_GAME_PLY)
+    {
+        std::size_t kept = std::min(static_cast<std::size_t>(std::min(halfmove_clock, plies_from_null)), MAX_GAME_PLY / 2);
+        std::copy(move_history.begin() + static_cast<std::ptrdiff_t>(history_size - kept),
+                  move_history.begin() + static_cast<std::ptrdiff_t>(history_size),
+                  move_history.begin());
+        history_size = kept;
+        plies_from_null = static_cast<int>(kept);
+    }
+
     make_move(move);
-    u_int64_t hash_key = zobrist_hash();
-    threefold_map.increment(hash_key);
 }
 
 // Method to play move in internal memory
 void BoardRepresentation::make_move(const Move &move)
 {
-    // References to indexes in the board representation array
-    char &piece_on_start_square = board[move.start_square.rank][move.start_square.file];
-    char &piece_on_target_square = board[move.to_square.rank][move.to_square.file];
+    const Square from = move.start_square();
+    const Square to = move.to_square();
 
-    // Track the board status before the move to allow for redo
-    move_stack.push(MoveState(
-        white_can_castle_kingside,
-        white_can_castle_queenside,
-        black_can_castle_kingside,
-        black_can_castle_queenside,
-        en_passant_square,
-        halfmove_clock,
-        fullmove_number,
-        piece_on_target_square, // If any piece is captured by this move
-        white_to_move));
-
-    // Determine which piece is moving and its color
-    char moving_piece = board[move.start_square.rank][move.start_square.file];
+    // Determine which piece is moving, what it captures and its color
+    char moving_piece = board[from.rank][from.file];
+    char captured_piece = board[to.rank][to.file];
     bool is_white = is_white_piece(moving_piece);
 
+    // Track the board status before the move to allow for redo
+    save_state(captured_piece);
+    plies_from_null++;
+
+    // Take the old castling rights and en passant file out of the hash, the new ones are added back at the end
+    hash_key ^= castling_and_en_passant_hash();
+
     // Calculate is_capture by checking if the to_square is occupied by an opponent's piece
-    bool is_capture = (piece_on_target_square != 'e');
+    bool is_capture = (captured_piece != 'e');
     bool is_pawn_move = (moving_piece == 'p' || moving_piece == 'P');
 
     // Handle castling rights for king moves
-    if ((black_can_castle_kingside || black_can_castle_queenside) && (piece_on_start_square == 'k'))
+    if ((black_can_castle_kingside || black_can_castle_queenside) && (moving_piece == 'k'))
     {
         black_can_castle_kingside = false;
         black_can_castle_queenside = false;
     }
-    else if ((white_can_castle_kingside || white_can_castle_queenside) && (piece_on_start_square == 'K'))
+    else if ((white_can_castle_kingside || white_can_castle_queenside) && (moving_piece == 'K'))
     {
         white_can_castle_kingside = false;
         white_can_castle_queenside = false;
     }
 
     // Handle castling rights for rook moves and captures
-    if (((move.start_square.rank == 0) && (move.start_square.file == 7)) ||
-        ((move.to_square.rank == 0) && (move.to_square.file == 7)))
+    if (((from.rank == 0) && (from.file == 7)) ||
+        ((to.rank == 0) && (to.file == 7)))
     {
         white_can_castle_kingside = false;
     }
-    if (((move.start_square.rank == 0) && (move.start_square.file == 0)) ||
-        ((move.to_square.rank == 0) && (move.to_square.file == 0)))
+    if (((from.rank == 0) && (from.file == 0)) ||
+        ((to.rank == 0) && (to.file == 0)))
     {
         white_can_castle_queenside = false;
     }
-    if (((move.start_square.rank == 7) && (move.start_square.file == 7)) ||
-        ((move.to_square.rank == 7) && (move.to_square.file == 7)))
+    if (((from.rank == 7) && (from.file == 7)) ||
+        ((to.rank == 7) && (to.file == 7)))
     {
         black_can_castle_kingside = false;
     }
-    if (((move.start_square.rank == 7) && (move.start_square.file == 0)) ||
-        ((move.to_square.rank == 7) && (move.to_square.file == 0)))
+    if (((from.rank == 7) && (from.file == 0)) ||
+        ((to.rank == 7) && (to.file == 0)))
     {
         black_can_castle_queenside = false;
     }
 
-    // All moves require clearing the starting square
-    piece_on_start_square = 'e';
-    non_empty_squares.erase(move.start_square);
+    // All moves require clearing the starting square (and the target square for captures)
+    remove_piece(from.rank, from.file);
+    if (is_capture)
+    {
+        remove_piece(to.rank, to.file);
+    }
 
     // Set the value in the target square to that of the moving piece except for promotions
-    if (move.promotion_piece == 'x')
+    if (!move.is_promotion())
     {
-        piece_on_target_square = moving_piece;
+        place_piece(moving_piece, to.rank, to.file);
     }
     else
     {
-        if (is_white)
-        {
-            piece_on_target_square = move.promotion_piece - 32;
-        }
-        else
-        {
-            piece_on_target_square = move.promotion_piece;
-        }
+        place_piece(is_white ? static_cast<char>(move.promotion_piece() - 32) : move.promotion_piece(), to.rank, to.file);
     }
 
-    // add the move to square to non empty
-    non_empty_squares.insert(move.to_square);
-
-    // Handle moving rook in castling case
-    if (move.is_castle)
+    // Handle moving rook in castling case (castling rights are already revoked for king moves)
+    if (move.is_castle())
     {
-        // White castles
-        if (is_white)
-        {
-            if (move.to_square.file == 6)
-            {
-                board[0][5] = 'R';
-                board[0][7] = 'e';
-
-                non_empty_squares.insert(Square(0, 5));
-                non_empty_squares.erase(Square(0, 7));
-            }
-            else
-            {
-                board[0][3] = 'R';
-                board[0][0] = 'e';
-
-                non_empty_squares.insert(Square(0, 3));
-                non_empty_squares.erase(Square(0, 0));
-            }
-            // castling rights are already revoked for king moves
-        }
-        // black castles
-        else
-        {
-            if (move.to_square.file == 6)
-            {
-                board[7][5] = 'r';
-                board[7][7] = 'e';
-
-                non_empty_squares.insert(Square(7, 5));
-                non_empty_squares.erase(Square(7, 7));
-            }
-            else
-            {
-                board[7][3] = 'r';
-                board[7][0] = 'e';
+        char rook = is_white ? 'R' : 'r';
+        int8_t rook_from_file = (to.file == 6) ? 7 : 0;
+        int8_t rook_to_file = (to.file == 6) ? 5 : 3;
 
-                non_empty_squares.insert(Square(7, 3));
-                non_empty_squares.erase(Square(7, 0));
-            }
-        }
+        remove_piece(to.rank, rook_from_file);
+        place_piece(rook, to.rank, rook_to_file);
     }
 
     // remove opponent pawn for en passant move
-    else if (move.is_enpassant)
+    else if (move.is_enpassant())
     {
-        if (is_white)
-        {
-            board[move.to_square.rank - 1][move.to_square.file] = 'e';
-            non_empty_squares.erase(Square(move.to_square.rank - 1, move.to_square.file));
-        }
-        else
-        {
-            board[move.to_square.rank + 1][move.to_square.file] = 'e';
-            non_empty_squares.erase(Square(move.to_square.rank + 1, move.to_square.file));
-        }
+        remove_piece(is_white ? to.rank - 1 : to.rank + 1, to.file);
     }
 
     // Add en passant square for double pawn push (white)
-    if (moving_piece == 'P' && move.to_square.rank - move.start_square.rank == 2)
+    if (moving_piece == 'P' && to.rank - from.rank == 2)
     {
-        en_passant_square = Square(move.to_square.rank - 1, move.to_square.file);
+        en_passant_square = Square(to.rank - 1, to.file);
     }
 
     // Add en passant square for double pawn push black
-    else if (moving_piece == 'p' && move.to_square.rank - move.start_square.rank == -2)
+    else if (moving_piece == 'p' && to.rank - from.rank == -2)
     {
-        en_passant_square = Square(move.to_square.rank + 1, move.to_square.file);
+        en_passant_square = Square(to.rank + 1, to.file);
     }
 
     else if (en_passant_square.exists())
@@ -456,6 +554,7 @@ void BoardRepresentation::make_move(const Move &move)
 
     // Update the active color
     white_to_move = !white_to_move;
+    hash_key ^= castling_and_en_passant_hash() ^ ZOBRIST_SIDE_TO_MOVE;
 
     if (is_pawn_move || is_capture)
     {
@@ -465,14 +564,15 @@ void BoardRepresentation::make_move(const Move &move)
     {
         halfmove_clock++;
     }
+
+    assert(hash_key == compute_zobrist_hash());
 }
 
 // Revert a move in the internal board
 void BoardRepresentation::undo_move(const Move &move)
 {
     // Retrieve the last saved state
-    MoveState previous_state = move_stack.top();
-    move_stack.pop();
+    const MoveState &previous_state = move_history[--history_size];
 
     // Restore castling rights, en passant, and halfmove clock
     white_can_castle_kingside = previous_state.white_can_castle_kingside;
@@ -484,52 +584,86 @@ void BoardRepresentation::undo_move(const Move &move)
     fullmove_number = previous_state.fullmove_number;
     white_to_move = previous_state.white_to_move;
 
+    const Square from = move.start_square();
+    const Square to = move.to_square();
+
     // Step 1: Revert the piece move from `to_square` back to `start_square`
-    board[move.start_square.rank][move.start_square.file] = board[move.to_square.rank][move.to_square.file];
-    board[move.to_square.rank][move.to_square.file] = previous_state.piece_on_target_square; // Restore captured piece or set empty
+    char moved_piece = board[to.rank][to.file];
+    clear_square(to.rank, to.file);
 
-    // undo non empty square tracking
-    non_empty_squares.insert(move.start_square); // The starting square now has a piece
-    if (previous_state.piece_on_target_square == 'e')
+    // Promotion: Replace the promoted piece back with a pawn
+    if (move.is_promotion())
     {
-        non_empty_squares.erase(move.to_square); // The target square becomes empty
+        moved_piece = (white_to_move) ? 'P' : 'p';
     }
+    set_square(moved_piece, from.rank, from.file);
 
-    // Step 2: Handle special cases
-    if (move.is_enpassant)
+    // Restore captured piece
+    if (previous_state.piece_on_target_square != 'e')
     {
-        // En passant: Place the captured pawn back on the appropriate square
-        int captured_pawn_rank = (board[move.start_square.rank][move.start_square.file] == 'P') ? move.to_square.rank - 1 : move.to_square.rank + 1;
-        board[captured_pawn_rank][move.to_square.file] = (board[move.start_square.rank][move.start_square.file] == 'P') ? 'p' : 'P';
-        board[move.to_square.rank][move.to_square.file] = 'e'; // Empty the en passant target square
-
-        non_empty_squares.insert(Square(static_cast<int8_t>(captured_pawn_rank), move.to_square.file)); // Restore the captured pawn
+        set_square(previous_state.piece_on_target_square, to.rank, to.file);
     }
-    else if (move.promotion_piece != 'x')
+
+    // Step 2: Handle special cases
+    if (move.is_enpassant())
     {
-        // Promotion: Replace the promoted piece back with a pawn
-        board[move.start_square.rank][move.start_square.file] = (white_to_move) ? 'P' : 'p';
+        // En passant: Place the captured pawn back on the appropriate square
+        int8_t captured_pawn_rank = (moved_piece == 'P') ? to.rank - 1 : to.rank + 1;
+        set_square((moved_piece == 'P') ? 'p' : 'P', captured_pawn_rank, to.file);
     }
-    else if (move.is_castle)
+    else if (move.is_castle())
     {
         // Castling: Move the rook back to its original position
-        if (move.to_square.file == 6)
-        {                                                                                 // Kingside castling
-            board[move.start_square.rank][5] = 'e';                                       // Clear the rook's castling square
-            board[move.start_square.rank][7] = (move.start_square.rank == 0) ? 'R' : 'r'; // Restore rook on original square
+        int8_t rook_from_file = (to.file == 6) ? 7 : 0;
+        int8_t rook_to_file = (to.file == 6) ? 5 : 3;
+
+        clear_square(from.rank, rook_to_file);
+        set_square((from.rank == 0) ? 'R' : 'r', from.rank, rook_from_file);
+    }
+
+    // The squares above were set without touching the hash or scores, restore them as they were before the move
+    hash_key = previous_state.hash_key;
+    pawn_key = previous_state.pawn_key;
+    material[0] = previous_state.material[0];
+    material[1] = previous_state.material[1];
+    midgame_score = previous_state.midgame_score;
+    endgame_score = previous_state.endgame_score;
+    plies_from_null = previous_state.plies_from_null;
+    assert(hash_key == compute_zobrist_hash());
+}
 
-            non_empty_squares.erase(Square(move.start_square.rank, 5));  // The square where the rook moved is now empty
-            non_empty_squares.insert(Square(move.start_square.rank, 7)); // The rook's original position is restored
-        }
-        else if (move.to_square.file == 2)
-        {                                                                                 // Queenside castling
-            board[move.start_square.rank][3] = 'e';                                       // Clear the rook's castling square
-            board[move.start_square.rank][0] = (move.start_square.rank == 0) ? 'R' : 'r'; // Restore rook on original square
+// Pass the turn: only the side to move and the en passant square change
+void BoardRepresentation::make_null_move()
+{
+    save_state('e');
+    plies_from_null = 0;
 
-            non_empty_squares.erase(Square(move.start_square.rank, 3));  // The square where the rook moved is now empty
-            non_empty_squares.insert(Square(move.start_square.rank, 0)); // The rook's original position is restored
-        }
+    hash_key ^= castling_and_en_passant_hash();
+    en_passant_square = Square(-1, -1);
+
+    if (!white_to_move)
+    {
+        fullmove_number++;
     }
+    white_to_move = !white_to_move;
+    halfmove_clock++;
+    hash_key ^= castling_and_en_passant_hash() ^ ZOBRIST_SIDE_TO_MOVE;
+
+    assert(hash_key == compute_zobrist_hash());
+}
+
+void BoardRepresentation::undo_null_move()
+{
+    const MoveState &previous_state = move_history[--history_size];
+
+    en_passant_square = previous_state.en_passant_square;
+    halfmove_clock = previous_state.halfmove_clock;
+    fullmove_number = previous_state.fullmove_number;
+    white_to_move = previous_state.white_to_move;
+    hash_key = previous_state.hash_key;
+    plies_from_null = previous_state.plies_from_null;
+
+    assert(hash_key == compute_zobrist_hash());
 }
 
 // Method to play move from UCI command
@@ -584,7 +718,7 @@ const Move BoardRepresentation::make_move(const std::string &move)
 
 bool BoardRepresentation::move_captures_king(const Move &move) const
 {
-    const char &piece_on_target_square = board[move.to_square.rank][move.to_square.file];
+    const char &piece_on_target_square = board[move.to_square().rank][move.to_square().file];
 
     return ((piece_on_target_square == 'K') || (piece_on_target_square == 'k'));
 }
@@ -783,60 +917,17 @@ bool BoardRepresentation::is_only_between(const Square &square_a, const Square &
     }
 }
 
-inline int piece_to_index(char piece)
+std::uint64_t BoardRepresentation::compute_zobrist_hash() const
 {
-    switch (piece)
-    {
-    case 'P':
-        return 0; // White Pawn
-    case 'N':
-        return 1; // White Knight
-    case 'B':
-        return 2; // White Bishop
-    case 'R':
-        return 3; // White Rook
-    case 'Q':
-        return 4; // White Queen
-    case 'K':
-        return 5; // White King
-
-    case 'p':
-        return 6; // Black Pawn
-    case 'n':
-        return 7; // Black Knight
-    case 'b':
-        return 8; // Black Bishop
-    case 'r':
-        return 9; // Black Rook
-    case 'q':
-        return 10; // Black Queen
-    case 'k':
-        return 11; // Black King
-
-    default:
-        return -1; // 'e' or invalid
-    }
-}
-
-std::uint64_t BoardRepresentation::zobrist_hash() const
-{
-    std::uint64_t h = 0ULL;
+    std::uint64_t h = castling_and_en_passant_hash();
 
     // 1. Pieces on squares
-    for (int rank = 0; rank < 8; ++rank)
+    for (int piece_index = 0; piece_index < 12; ++piece_index)
     {
-        for (int file = 0; file < 8; ++file)
+        u64 pieces = piece_bitboards[piece_index];
+        while (pieces)
         {
-            char piece = board[rank][file]; // e.g., 'P', 'p', 'N', 'e', etc.
-            if (piece != 'e')
-            {
-                int pieceIndex = piece_to_index(piece);
-                if (pieceIndex >= 0)
-                {
-                    int squareIndex = rank * 8 + file;
-                    h ^= ZOBRIST_PIECE[pieceIndex][squareIndex];
-                }
-            }
+            h ^= ZOBRIST_PIECE[piece_index][pop_LSB(pieces)];
         }
     }
 
@@ -846,7 +937,14 @@ std::uint64_t BoardRepresentation::zobrist_hash() const
         h ^= ZOBRIST_SIDE_TO_MOVE;
     }
 
-    // 3. Castling rights
+    return h;
+}
+
+std::uint64_t BoardRepresentation::castling_and_en_passant_hash() const
+{
+    std::uint64_t h = 0ULL;
+
+    // Castling rights
     if (white_can_castle_kingside)
         h ^= ZOBRIST_CASTLING[0];
     if (white_can_castle_queenside)
@@ -856,7 +954,7 @@ std::uint64_t BoardRepresentation::zobrist_hash() const
     if (black_can_castle_queenside)
         h ^= ZOBRIST_CASTLING[3];
 
-    // 4. En passant
+    // En passant
     // If en_passant_square is valid, XOR its file
     if (en_passant_square.exists())
     {
@@ -6,142 +6,151 @@
 #include <functional>
 #include <vector>
 #include <limits>
-
-Evaluation find_best_move(BoardRepresentation &board_representation,
-                          TranspositionTable &transposition_table,
-                          bool am_logging,
-                          int wtime, int btime,
-                          int winc, int binc,
-                          int forced_time)
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+namespace
 {
-    // Capture start time (used for logging allocated time)
-    auto start_time = std::chrono::steady_clock::now();
+    // Late move reductions indexed by [remaining depth][move number], filled once at startup
+    using ReductionTable = std::array<std::array<int, LMR_TABLE_SIZE>, LMR_TABLE_SIZE>;
 
-    // Create cutoff time using your time allocation logic
-    double remaining_material_ratio = get_remaining_material(board_representation);
-    std::chrono::milliseconds cutoff_ms = (forced_time < 0)
-                                              ? find_time_condition(
-                                                    remaining_material_ratio,
-                                                    wtime, btime,
-                                                    winc, binc,
-                                                    board_representation.white_to_move)
-                                              : std::chrono::milliseconds(forced_time);
+    ReductionTable build_reduction_table()
+    {
+        ReductionTable table{};
+        for (int depth = 1; depth < LMR_TABLE_SIZE; ++depth)
+        {
+            for (int move_number = 1; move_number < LMR_TABLE_SIZE; ++move_number)
+            {
+                table[static_cast<std::size_t>(depth)][static_cast<std::size_t>(move_number)] =
+                    static_cast<int>(0.75 + std::log(depth) * std::log(move_number) / 2.25);
+            }
+        }
+        return table;
+    }
 
-    std::chrono::time_point<std::chrono::steady_clock> cutoff_time = start_time + cutoff_ms;
+    const ReductionTable LMR_REDUCTIONS = build_reduction_table();
 
-    ThreadSafeLogger &logger = ThreadSafeLogger::getInstance("logs/app_log.txt");
+    // Every search thread scores pawn structures into its own table
+    thread_local PawnHashTable pawn_hash_table;
 
-    // Log the allocated time in milliseconds
-    if (am_logging)
+    // Shelter of a king without castling rights: a bonus per pawn next to it and a penalty when no pawn covers its file
+    int king_shelter_bonus(u64 king, u64 pawns)
     {
-        auto allocated_time = cutoff_ms.count();
-        std::ostringstream oss;
-        oss << "Allocated " << allocated_time << " milliseconds";
-        logger.write("Debug", oss.str());
+        if (!king)
+        {
+            return 0;
+        }
+
+        int king_square = get_LSB_index(king);
+        int bonus = count_bits(KING_ATTACKS[king_square] & pawns) * CLOSE_PAWN_BONUS;
+        if (!(pawns & (FILE_A << (king_square % 8))))
+        {
+            bonus -= OPEN_KING_FILE_PENALTY;
+        }
+        return bonus;
     }
 
-    // Create the time-based stop condition
-    auto time_stop_condition = [cutoff_time]()
+    // Lazy SMP helper: searches its own copy of the board and only contributes through the shared TT
+    void run_helper_search(BoardRepresentation board_representation,
+                           TranspositionTable &transposition_table,
+                           MoveList top_depth_moves,
+                           SearchLimits &limits,
+                           int helper_index)
     {
-        return std::chrono::steady_clock::now() >= cutoff_time;
-    };
+        bool stop_flag = false;
+        SearchHeuristics heuristics;
 
-    // Call the unified function
-    return run_iterative_deepening(board_representation,
-                                   transposition_table,
-                                   am_logging,
-                                   time_stop_condition);
+        // Odd helpers run a ply ahead of the main thread so the threads spread over different depths
+        int depth = MIN_DEPTH_SEARCHED + helper_index % 2;
+
+        // Start each helper on a different root move so they fill the TT with different subtrees
+        std::rotate(top_depth_moves.begin(),
+                    top_depth_moves.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(helper_index) % top_depth_moves.size()),
+                    top_depth_moves.end());
+
+        while (!limits.stopped() && depth <= MAX_SEARCH_DEPTH)
+        {
+            Evaluation helper_evaluation = search(board_representation,
+                                                  transposition_table,
+                                                  top_depth_moves,
+                                                  depth,
+                                                  -std::numeric_limits<int>::max(),
+                                                  std::numeric_limits<int>::max(),
+                                                  depth,
+                                                  limits,
+                                                  heuristics,
+                                                  0,
+                                                  stop_flag);
+
+            if (helper_evaluation.best_move.is_instantiated() && !stop_flag)
+            {
+                bump_best_move_to_front(top_depth_moves, helper_evaluation.best_move);
+            }
+            ++depth;
+        }
+    }
 }
 
-void ponder(BoardRepresentation &board_representation,
-            TranspositionTable &transposition_table,
-            Move &next_ponder_move,
-            Move &best_move_found,
-            bool am_logging,
-            const std::atomic<bool> &ponder_hit,
-            const std::atomic<bool> &hard_stop,
-            int wtime,
-            int btime,
-            int winc,
-            int binc,
-            int forced_time)
+std::chrono::milliseconds allocate_search_time(BoardRepresentation &board_representation,
+                                               int wtime, int btime,
+                                               int winc, int binc,
+                                               int forced_time)
 {
-    ThreadSafeLogger &logger = ThreadSafeLogger::getInstance("logs/app_log.txt");
+    if (forced_time >= 0)
+    {
+        return std::chrono::milliseconds(forced_time);
+    }
 
-    // Get remaining material ratio for time calculation
-    double remaining_material_ratio = get_remaining_material(board_representation);
+    return find_time_condition(get_remaining_material(board_representation),
+                               wtime, btime,
+                               winc, binc,
+                               board_representation.white_to_move);
+}
 
-    // Determine how much time (in ms) we would allocate if we were to start timing now
-    // find_time_condition now returns a std::chrono::milliseconds duration
-    std::chrono::milliseconds allocated_time = (forced_time < 0)
-                                                   ? find_time_condition(remaining_material_ratio,
-                                                                         wtime, btime,
-                                                                         winc, binc,
-                                                                         board_representation.white_to_move)
-                                                   : std::chrono::milliseconds(forced_time);
+Evaluation find_best_move(BoardRepresentation &board_representation,
+                          TranspositionTable &transposition_table,
+                          bool am_logging,
+                          int wtime, int btime,
+                          int winc, int binc,
+                          int forced_time,
+                          SearchLimits *limits,
+                          int threads)
+{
+    // Callers that never need to stop the search early do not have to supply limits
+    SearchLimits local_limits;
+    SearchLimits &search_limits = (limits != nullptr) ? *limits : local_limits;
 
-    auto base_allocated_ms = allocated_time.count();
+    search_limits.set_time_budget(allocate_search_time(board_representation,
+                                                       wtime, btime,
+                                                       winc, binc,
+                                                       forced_time));
+    search_limits.start_clock();
 
+    // Log the allocated time in milliseconds
     if (am_logging)
     {
+        ThreadSafeLogger &logger = ThreadSafeLogger::getInstance("logs/app_log.txt");
         std::ostringstream oss;
-        oss << "Pondering will have up to " << base_allocated_ms
-            << " ms after receiving ponderhit";
+        oss << "Allocated " << search_limits.get_time_budget().count() << " milliseconds";
         logger.write("Debug", oss.str());
     }
 
-    // We do not start applying the allocated time until we detect stop_pondering == true
-    bool time_limit_active = false;
-    std::chrono::steady_clock::time_point actual_cutoff;
-
-    // Stop condition logic for indefinite pondering until stop_pondering is set
-    auto ponder_stop_condition = [&]()
-    {
-        if (hard_stop.load()) // hard stop will always stop execution right away
-        {
-            logger.write("Debug", "Ponder received stop signal. Stopping immediately.");
-            return true;
-        }
-
-        // Phase 1: indefinite pondering
-        if (!ponder_hit.load())
-        {
-            return false;
-        }
-        // Phase 2: once stop signal is received, switch to time-limited search
-        if (!time_limit_active)
-        {
-            time_limit_active = true;
-            auto now = std::chrono::steady_clock::now();
-            actual_cutoff = now + std::chrono::milliseconds(base_allocated_ms);
-
-            if (am_logging)
-            {
-                std::ostringstream oss;
-                oss << "Pondering received ponderhit signal. Now searching up to "
-                    << base_allocated_ms << " ms more.";
-                logger.write("Debug", oss.str());
-            }
-        }
-        // Stop if we've reached our newly enforced time cutoff
-        return (std::chrono::steady_clock::now() >= actual_cutoff);
-    };
-
-    // Use the same iterative deepening search
-    Evaluation position_evaluation = run_iterative_deepening(board_representation,
-                                                             transposition_table,
-                                                             am_logging,
-                                                             ponder_stop_condition);
-
-    // Extract best and ponder moves from the final evaluation
-    best_move_found = position_evaluation.best_move;
-    next_ponder_move = position_evaluation.ponder_move;
+    return run_iterative_deepening(board_representation,
+                                   transposition_table,
+                                   am_logging,
+                                   search_limits,
+                                   threads);
 }
 
 Evaluation run_iterative_deepening(BoardRepresentation &board_representation,
                                    TranspositionTable &transposition_table,
                                    bool am_logging,
-                                   std::function<bool()> stop_condition)
+                                   SearchLimits &limits,
+                                   int threads)
 {
     Evaluation position_evaluation;
 
@@ -149,41 +158,105 @@ Evaluation run_iterative_deepening(BoardRepresentation &board_representation,
     auto start_time = std::chrono::steady_clock::now();
     ThreadSafeLogger &logger = ThreadSafeLogger::getInstance("logs/app_log.txt");
 
-    double remaining_material_ratio = get_remaining_material(board_representation);
 
     bool stop_flag = false;
 
+    SearchHeuristics heuristics;
+
     std::vector<Evaluation> eval_by_depth;
 
-    std::vector<Move> top_depth_moves;
+    MoveList top_depth_moves;
     generate_legal_moves(board_representation, top_depth_moves);
 
-    if (top_depth_moves.empty() || board_representation.threefold_map.hasAnyThreefold())
+    if (top_depth_moves.empty() || board_representation.is_repetition(0))
     {
         throw std::runtime_error("Cannot evaluate terminal position.");
     }
     sort_for_pruning(top_depth_moves, board_representation);
 
+    // Each helper gets its own limits so node counts stay per thread; they stop when this thread does
+    std::size_t helper_count = static_cast<std::size_t>(std::max(threads - 1, 0));
+    std::unique_ptr<SearchLimits[]> helper_limits = std::make_unique<SearchLimits[]>(helper_count);
+    std::vector<std::thread> helpers;
+    for (std::size_t i = 0; i < helper_count; ++i)
+    {
+        helpers.emplace_back(run_helper_search,
+                             board_representation,
+                             std::ref(transposition_table),
+                             top_depth_moves,
+                             std::ref(helper_limits[i]),
+                             static_cast<int>(i) + 1);
+    }
+
+    const int full_window = std::numeric_limits<int>::max();
+
     do
     {
-        position_evaluation = search(board_representation,
-                                     transposition_table,
-                                     top_depth_moves,
-                                     depth,
-                                     -std::numeric_limits<int>::max(),
-                                     std::numeric_limits<int>::max(),
-                                     remaining_material_ratio,
-                                     depth,
-                                     stop_condition,
-                                     stop_flag);
+        // Aspiration window around the previous score, skipped for mates whose score shifts with depth
+        int window = ASPIRATION_WINDOW;
+        int alpha = -full_window, beta = full_window;
+        bool failed_low = false;
+        if (!eval_by_depth.empty() && std::abs(eval_by_depth.back().evaluation) < MATE_SCORE - MAX_SEARCH_DEPTH)
+        {
+            alpha = eval_by_depth.back().evaluation - window;
+            beta = eval_by_depth.back().evaluation + window;
+        }
+
+        while (true)
+        {
+            position_evaluation = search(board_representation,
+                                         transposition_table,
+                                         top_depth_moves,
+                                         depth,
+                                         alpha,
+                                         beta,
+                                         depth,
+                                         limits,
+                                         heuristics,
+                                         0,
+                                         stop_flag);
+
+            // A fail low only bounds the score from above, so its move is not trustworthy
+            failed_low = position_evaluation.evaluation <= alpha && alpha != -full_window;
+            bool failed_high = position_evaluation.evaluation >= beta && beta != full_window;
+            if (stop_flag || (!failed_low && !failed_high))
+            {
+                break;
+            }
+
+            // Widen the side that failed, falling back to a full window
+            window *= ASPIRATION_GROWTH;
+            int previous = eval_by_depth.back().evaluation;
+            if (failed_low)
+            {
+                alpha = (window > MAX_ASPIRATION_WINDOW) ? -full_window : previous - window;
+            }
+            else
+            {
+                beta = (window > MAX_ASPIRATION_WINDOW) ? full_window : previous + window;
+            }
+        }
 
-        if (position_evaluation.best_move.is_instantiated())
+        if (position_evaluation.best_move.is_instantiated() && !failed_low)
         {
             eval_by_depth.push_back(position_evaluation);
             bump_best_move_to_front(top_depth_moves, position_evaluation.best_move);
         }
         ++depth;
-    } while (!stop_condition());
+
+        // Short iterations may finish between node-count clock checks
+        limits.check_clock();
+        // Deeper iterations would overflow the TT depth field, the per-ply heuristics and the undo history
+    } while (!limits.stopped() && depth <= MAX_SEARCH_DEPTH && (limits.max_depth == 0 || depth <= limits.max_depth));
+
+    for (std::size_t i = 0; i < helper_count; ++i)
+    {
+        helper_limits[i].stop();
+    }
+    for (std::thread &helper : helpers)
+    {
+        helper.join();
+    }
 
     if (eval_by_depth.empty())
     {
@@ -199,7 +272,8 @@ Evaluation run_iterative_deepening(BoardRepresentation &board_representation,
 
         {
             std::ostringstream oss;
-            oss << "Searched depth " << depth << " in " << elapsed_time << " milliseconds";
+            oss << "Searched depth " << depth << " (" << limits.nodes_searched() << " nodes) in "
+                << elapsed_time << " milliseconds";
             logger.write("Debug", oss.str());
         }
 
@@ -226,66 +300,57 @@ Evaluation run_iterative_deepening(BoardRepresentation &board_representation,
 // make sure move ordering is handled between iterations and interrupts are correctly handled
 Evaluation search(BoardRepresentation &board_representation,
                   TranspositionTable &transposition_table,
-                  std::vector<Move> &top_depth_moves,
+                  MoveList &top_depth_moves,
                   int depth,
                   int alpha,
                   int beta,
-                  double remaining_material_ratio,
                   int starting_depth,
-                  const std::function<bool()> &should_stop,
-                  bool &stop_flag)
+                  SearchLimits &limits,
+                  SearchHeuristics &heuristics,
+                  int ply,
+                  bool &stop_flag,
+                  bool allow_null_move)
 {
+    limits.count_node();
+
     // Store the original alpha so we can decide on EntryType later
     int original_alpha = alpha;
 
     // Zobrist hash for the current position
     std::uint64_t hash_key = board_representation.zobrist_hash();
 
-    if (depth != starting_depth) // starting position is already accounted for
-    {
-        board_representation.threefold_map.increment(hash_key);
-    }
-
-    // If this position has appeared at least 3 times, declare a draw
-    if (board_representation.threefold_map.hasThreefold(hash_key))
+    // A repetition inside the tree is scored as a draw right away, one with the game history needs a third occurrence
+    if (ply > 0 && board_representation.is_repetition(ply))
     {
-        // Decrement on returning
-        board_representation.threefold_map.decrement(hash_key);
         return Evaluation(0);
     }
 
     // -----------------
     // Transposition Table Lookup
     // -----------------
-    const TranspositionRow *entry = transposition_table.get(hash_key);
+    TranspositionRow entry;
     Move precomputed_best_move;
 
-    if (entry != nullptr)
+    if (transposition_table.get(hash_key, entry))
     {
-        if (entry->depth >= depth)
+        if (entry.depth >= depth)
         {
-            if (entry->entry_type == EntryType::Alpha && entry->eval <= alpha)
+            if (entry.entry_type == EntryType::Alpha && entry.eval <= alpha)
             {
-                // Cleanup before return
-                board_representation.threefold_map.decrement(hash_key);
-                return Evaluation(entry->best_move, entry->best_response, entry->eval);
+                return Evaluation(entry.best_move, entry.best_response, entry.eval);
             }
-            else if (entry->entry_type == EntryType::Beta && entry->eval >= beta)
+            else if (entry.entry_type == EntryType::Beta && entry.eval >= beta)
             {
-                // Cleanup before return
-                board_representation.threefold_map.decrement(hash_key);
-                return Evaluation(entry->best_move, entry->best_response, entry->eval);
+                return Evaluation(entry.best_move, entry.best_response, entry.eval);
             }
-            else if (entry->entry_type == EntryType::PV)
+            else if (entry.entry_type == EntryType::PV)
             {
-                // Cleanup before return
-                board_representation.threefold_map.decrement(hash_key);
-                return Evaluation(entry->best_move, entry->best_response, entry->eval);
+                return Evaluation(entry.best_move, entry.best_response, entry.eval);
             }
         }
 
         // Use the stored best move for reordering
-        precomputed_best_move = entry->best_move;
+        precomputed_best_move = entry.best_move;
     }
 
     // -----------------
@@ -293,23 +358,19 @@ Evaluation search(BoardRepresentation &board_representation,
     // -----------------
     if (depth == 0)
     {
-        int score = search_captures(board_representation, alpha, beta, remaining_material_ratio);
-
-        // Decrement frequency map on return
-        board_representation.threefold_map.decrement(hash_key);
+        int score = search_captures(board_representation, transposition_table, limits, alpha, beta);
         return Evaluation(score);
     }
 
     // -----------------
     // Move Generation
     // -----------------
-    std::vector<Move> local_move_list;
-    std::vector<Move> &move_list = (depth == starting_depth) ? top_depth_moves : local_move_list;
+    MoveList local_move_list;
+    MoveList &move_list = (depth == starting_depth) ? top_depth_moves : local_move_list;
 
     if (depth != starting_depth)
     {
         generate_legal_moves(board_representation, move_list);
-        sort_for_pruning(move_list, board_representation);
     }
 
     // -----------------
@@ -319,56 +380,164 @@ Evaluation search(BoardRepresentation &board_representation,
     {
         if (board_representation.is_in_check)
         {
-            // Faster mates get higher scores
-            int mate_score = -(MATE_SCORE - (starting_depth - depth));
-            board_representation.threefold_map.decrement(hash_key);
+            // Faster mates get higher scores. Reductions skip depth, so count the distance in plies
+            int mate_score = -(MATE_SCORE - ply);
             return Evaluation(mate_score);
         }
         else
         {
             // Stalemate
-            board_representation.threefold_map.decrement(hash_key);
             return Evaluation(0);
         }
     }
 
+    // Child searches overwrite is_in_check, so keep this node's value. The root reuses its move list
+    // instead of generating it here, so the flag still holds whatever the last search left behind
+    bool in_check = (depth == starting_depth) ? gives_check(board_representation) : board_representation.is_in_check;
+
+    // -----------------
+    // Null-Move Pruning
+    // -----------------
+    // If passing still fails high, a real move would too. Passing is only unsafe in check, back to back,
+    // near mate scores and without pieces, where zugzwang makes passing better than any move
+    if (allow_null_move &&
+        depth != starting_depth &&
+        depth >= NULL_MOVE_MIN_DEPTH &&
+        !in_check &&
+        std::abs(beta) < MATE_SCORE - MAX_SEARCH_DEPTH &&
+        has_non_pawn_material(board_representation))
+    {
+        int reduction = (depth >= NULL_MOVE_DEEP_DEPTH) ? 3 : 2;
+
+        heuristics.set_played(ply, Move());
+        board_representation.make_null_move();
+        Evaluation null_evaluation = search(board_representation,
+                                            transposition_table,
+                                            top_depth_moves,
+                                            std::max(depth - 1 - reduction, 0),
+                                            -beta,
+                                            -beta + 1,
+                                            starting_depth,
+                                            limits,
+                                            heuristics,
+                                            ply + 1,
+                                            stop_flag,
+                                            false);
+        board_representation.undo_null_move();
+
+        if (!stop_flag && -null_evaluation.evaluation >= beta)
+        {
+            return Evaluation(beta);
+        }
+    }
+
     // -----------------
-    // If we have a best move from TT, reorder
+    // If we have a best move from TT, reorder the root (other nodes hand it to the move picker)
     // -----------------
-    if (precomputed_best_move.is_instantiated())
+    if (depth == starting_depth && precomputed_best_move.is_instantiated())
     {
         bump_best_move_to_front(move_list, precomputed_best_move);
     }
 
     // -----------------
-    // Alpha-Beta Loop
+    // Principal Variation Search
     // -----------------
     int best_score = -std::numeric_limits<int>::max();
     Move best_move, best_response;
+    bool first_move = true;
+    int move_number = 0;
+
+    // The root keeps the order iterative deepening built up, other nodes pick moves lazily
+    MovePicker picker(move_list, board_representation, heuristics, precomputed_best_move, ply);
+    std::size_t root_index = 0;
+    Move move;
 
-    for (const Move &move : move_list)
+    while (depth == starting_depth ? root_index < move_list.size() : picker.next_move(move))
     {
+        if (depth == starting_depth)
+        {
+            move = move_list[root_index++];
+        }
+
         // Check stop condition
-        if (should_stop() && starting_depth != MIN_DEPTH_SEARCHED)
+        if (limits.stopped() && starting_depth != MIN_DEPTH_SEARCHED)
         {
             stop_flag = true;
             break;
         }
 
+        ++move_number;
+        bool is_quiet = board_representation.board[move.to_square().rank][move.to_square().file] == 'e' &&
+                        !move.is_enpassant() && !move.is_promotion();
+
+        heuristics.set_played(ply, move);
         board_representation.make_move(move);
 
-        Evaluation evaluation = search(board_representation,
-                                       transposition_table,
-                                       top_depth_moves,
-                                       depth - 1,
-                                       -beta,
-                                       -alpha,
-                                       remaining_material_ratio,
-                                       starting_depth,
-                                       should_stop,
-                                       stop_flag);
+        // Late Move Reductions: quiet moves far down the ordering are unlikely to raise alpha
+        int reduction = 0;
+        if (!first_move && is_quiet && !in_check && !heuristics.is_killer(ply, move) &&
+            depth >= LMR_MIN_DEPTH && move_number >= LMR_MIN_MOVE_NUMBER &&
+            !gives_check(board_representation))
+        {
+            reduction = LMR_REDUCTIONS[static_cast<std::size_t>(std::min(depth, LMR_TABLE_SIZE - 1))]
+                                      [static_cast<std::size_t>(std::min(move_number, LMR_TABLE_SIZE - 1))];
+            reduction = std::clamp(reduction, 0, depth - 2); // always leave at least one ply
+        }
 
-        int score = evaluation.evaluation * -1; // Minimax inverting
+        Evaluation evaluation;
+        int score = 0;
+        if (!first_move)
+        {
+            // Null window: only prove this move is no better than the current best
+            evaluation = search(board_representation,
+                                transposition_table,
+                                top_depth_moves,
+                                depth - 1 - reduction,
+                                -alpha - 1,
+                                -alpha,
+                                starting_depth,
+                                limits,
+                                heuristics,
+                                ply + 1,
+                                stop_flag);
+            score = -evaluation.evaluation; // Minimax inverting
+
+            // A reduced move that beats alpha has to prove it at full depth
+            if (reduction > 0 && !stop_flag && score > alpha)
+            {
+                evaluation = search(board_representation,
+                                    transposition_table,
+                                    top_depth_moves,
+                                    depth - 1,
+                                    -alpha - 1,
+                                    -alpha,
+                                    starting_depth,
+                                    limits,
+                                    heuristics,
+                                    ply + 1,
+                                    stop_flag);
+                score = -evaluation.evaluation;
+            }
+        }
+
+        // The first move, or a later one that beat alpha, needs its exact score
+        if (first_move || (!stop_flag && score > alpha && score < beta))
+        {
+            evaluation = search(board_representation,
+                                transposition_table,
+                                top_depth_moves,
+                                depth - 1,
+                                -beta,
+                                -alpha,
+                                starting_depth,
+                                limits,
+                                heuristics,
+                                ply + 1,
+                                stop_flag);
+
+            score = -evaluation.evaluation;
+        }
+        first_move = false;
 
         board_representation.undo_move(move);
 
@@ -391,19 +560,15 @@ Evaluation search(BoardRepresentation &board_representation,
             // Cutoff
             if (alpha >= beta)
             {
+                if (is_quiet)
+                {
+                    heuristics.update_quiet_cutoff(board_representation.white_to_move, ply, depth, move);
+                }
                 break;
             }
         }
     }
 
-    // -----------------
-    // Decrement frequency map on return
-    // -----------------
-    if (depth != starting_depth) // input position is fully accounted for before searching
-    {
-        board_representation.threefold_map.decrement(hash_key);
-    }
-
     // -----------------
     // Write to TT if not interrupted
     // -----------------
@@ -430,15 +595,39 @@ Evaluation search(BoardRepresentation &board_representation,
 }
 
 int search_captures(BoardRepresentation &board_representation,
+                    TranspositionTable &transposition_table,
+                    SearchLimits &limits,
                     int alpha,
-                    int beta,
-                    double remaining_material_ratio)
+                    int beta)
 {
+    // Store the original alpha so we can decide on EntryType later
+    int original_alpha = alpha;
+    std::uint64_t hash_key = board_representation.zobrist_hash();
+
+    // -----------------
+    // Transposition Table Lookup
+    // -----------------
+    // Any stored search is at least as deep as quiescence, so only the bound decides
+    TranspositionRow entry;
+    Move precomputed_best_move;
+
+    if (transposition_table.get(hash_key, entry))
+    {
+        if ((entry.entry_type == EntryType::Alpha && entry.eval <= alpha) ||
+            (entry.entry_type == EntryType::Beta && entry.eval >= beta) ||
+            entry.entry_type == EntryType::PV)
+        {
+            return entry.eval;
+        }
+        precomputed_best_move = entry.best_move;
+    }
+
     // Evaluate current position
-    int evaluation = evaluate(board_representation, remaining_material_ratio);
+    int evaluation = evaluate(board_representation);
 
     if (evaluation >= beta)
     {
+        transposition_table.insert(hash_key, beta, QUIESCENCE_DEPTH, Move(), Move(), EntryType::Beta);
         return beta;
     }
 
@@ -447,51 +636,170 @@ int search_captures(BoardRepresentation &board_representation,
         alpha = evaluation;
     }
 
-    // Generate only capture moves
-    std::vector<Move> capture_moves;
+    // Generate only capture moves and score each once, the stored move first
+    MoveList capture_moves;
     generate_legal_moves(board_representation, capture_moves, /* capturesOnly = */ true);
-    sort_for_pruning(capture_moves, board_representation);
 
-    for (const Move &move : capture_moves)
+    int scores[MAX_MOVES];
+    for (std::size_t i = 0; i < capture_moves.size(); ++i)
     {
+        scores[i] = (capture_moves[i] == precomputed_best_move)
+                        ? std::numeric_limits<int>::max()
+                        : compute_move_score(capture_moves[i], board_representation);
+    }
+
+    Move best_move;
+    for (std::size_t i = 0; i < capture_moves.size(); ++i)
+    {
+        // Selection sort, so the rest is never ordered after a cutoff
+        std::size_t best = i;
+        for (std::size_t j = i + 1; j < capture_moves.size(); ++j)
+        {
+            if (scores[j] > scores[best])
+            {
+                best = j;
+            }
+        }
+        std::swap(capture_moves[i], capture_moves[best]);
+        std::swap(scores[i], scores[best]);
+
+        // Every remaining capture loses material on the exchange
+        if (scores[i] < GOOD_CAPTURE_SCORE)
+        {
+            break;
+        }
+
+        const Move &move = capture_moves[i];
         board_representation.make_move(move);
 
-        int score = -search_captures(board_representation, -beta, -alpha, remaining_material_ratio);
+        // The node entering quiescence was counted by search(), so each capture counts the one it leads to
+        limits.count_node();
+        int score = -search_captures(board_representation, transposition_table, limits, -beta, -alpha);
 
         board_representation.undo_move(move);
 
         if (score >= beta)
         {
+            transposition_table.insert(hash_key, beta, QUIESCENCE_DEPTH, move, Move(), EntryType::Beta);
             return beta;
         }
         if (score > alpha)
         {
             alpha = score;
+            best_move = move;
         }
     }
 
+    EntryType entry_type = (alpha > original_alpha) ? EntryType::PV : EntryType::Alpha;
+    transposition_table.insert(hash_key, alpha, QUIESCENCE_DEPTH, best_move, Move(), entry_type);
+
     return alpha;
 }
 
 double get_remaining_material(BoardRepresentation &board_representation)
 {
-    int material_count = 0;
+    // Kings are not part of the material count
+    int material_count = board_representation.material[0] + board_representation.material[1];
+
+    return static_cast<double>(material_count) / STARTING_MATERIAL;
+}
+
+bool gives_check(const BoardRepresentation &board_representation)
+{
+    // Called after make_move, so the side to move is the one that may be in check
+    int king = board_representation.white_to_move ? WHITE_KING : BLACK_KING;
+    int king_square = get_LSB_index(board_representation.piece_bitboards[king]);
+
+    return is_square_attacked_by(board_representation, king_square, !board_representation.white_to_move);
+}
+
+bool has_non_pawn_material(const BoardRepresentation &board_representation)
+{
+    u64 side_pieces = board_representation.white_to_move ? board_representation.white_pieces
+                                                         : board_representation.black_pieces;
+    int pawn = board_representation.white_to_move ? WHITE_PAWN : BLACK_PAWN;
+    int king = board_representation.white_to_move ? WHITE_KING : BLACK_KING;
+
+    return (side_pieces & ~board_representation.piece_bitboards[pawn] & ~board_representation.piece_bitboards[king]) != 0;
+}
+
+int static_exchange_evaluation(const BoardRepresentation &board_representation, const Move &move)
+{
+    // Piece values by PieceIndex type, the king is worth more than anything it could win
+    static constexpr int SEE_VALUES[6] = {100, 300, 300, 500, 900, 20000};
+    const u64 *bitboards = board_representation.piece_bitboards;
+
+    int from = move.from();
+    int to = move.to();
+    bool white = board_representation.white_to_move;
+
+    int moving_type = piece_to_index(board_representation.board[from / 8][from % 8]) % 6;
+    u64 occupied = board_representation.occupied ^ (1ULL << from);
 
-    for (const Square &square : board_representation.non_empty_squares)
+    int gain[32];
+    if (move.is_enpassant())
     {
-        char piece = board_representation.board[square.rank][square.file];
-        int piece_value = get_piece_value(piece);
+        gain[0] = SEE_VALUES[WHITE_PAWN];
+        occupied ^= 1ULL << (white ? to - 8 : to + 8);
+    }
+    else
+    {
+        char captured = board_representation.board[to / 8][to % 8];
+        gain[0] = (captured == 'e') ? 0 : SEE_VALUES[piece_to_index(captured) % 6];
+    }
+
+    // The piece now standing on the target square, which the next capture wins
+    int on_square_value = SEE_VALUES[moving_type];
+    if (move.is_promotion())
+    {
+        int promoted = piece_to_index(move.promotion_piece()) % 6;
+        gain[0] += SEE_VALUES[promoted] - SEE_VALUES[WHITE_PAWN];
+        on_square_value = SEE_VALUES[promoted];
+    }
+
+    u64 attackers = attackers_to(board_representation, to, occupied) & occupied;
+    bool side = !white;
+    int d = 0;
+
+    while (d < 31)
+    {
+        u64 side_attackers = attackers & (side ? board_representation.white_pieces : board_representation.black_pieces);
+        if (side_attackers == 0)
+        {
+            break;
+        }
 
-        // Exclude kings from the material count
-        if (tolower(piece) != 'k')
+        // Recapture with the least valuable attacker
+        int type = 0;
+        u64 candidates = 0;
+        for (; type < 6; ++type)
         {
-            material_count += piece_value;
+            candidates = side_attackers & bitboards[(side ? WHITE_PAWN : BLACK_PAWN) + type];
+            if (candidates != 0)
+            {
+                break;
+            }
         }
+
+        // Gain for this side if the exchange stopped after its capture
+        ++d;
+        gain[d] = on_square_value - gain[d - 1];
+
+        // Removing the attacker can uncover sliders behind it
+        occupied ^= candidates & (~candidates + 1);
+        attackers = attackers_to(board_representation, to, occupied) & occupied;
+        on_square_value = SEE_VALUES[type];
+        side = !side;
     }
 
-    // Calculate the ratio of remaining material (starting total material is 7800)
-    double remaining_material_ratio = static_cast<double>(material_count) / 7800.0;
-    return remaining_material_ratio;
+    // Each side may stop capturing when continuing would lose more
+    while (d > 0)
+    {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+        --d;
+    }
+
+    return gain[0];
 }
 
 int compute_move_score(const Move &move, const BoardRepresentation &board_representation)
@@ -499,22 +807,30 @@ int compute_move_score(const Move &move, const BoardRepresentation &board_repres
     int score = 0;
 
     // Determine if move is a capture
-    char captured_piece = board_representation.board[move.to_square.rank][move.to_square.file];
-    bool is_capture = captured_piece != 'e';
+    Square to = move.to_square();
+    Square from = move.start_square();
+    char captured_piece = board_representation.board[to.rank][to.file];
 
     // Get moving piece
-    char moving_piece = board_representation.board[move.start_square.rank][move.start_square.file];
+    char moving_piece = board_representation.board[from.rank][from.file];
+
+    // En passant lands on an empty square but still takes a pawn
+    if (move.is_enpassant())
+    {
+        captured_piece = (moving_piece == 'P') ? 'p' : 'P';
+    }
+    bool is_capture = captured_piece != 'e';
 
     // Get piece values
     int captured_value = get_piece_value(captured_piece);
     int moving_value = get_piece_value(moving_piece);
 
     // Determine if move is a pawn promotion
-    bool is_promotion = move.promotion_piece != 'x';
+    bool is_promotion = move.is_promotion();
 
     if (is_capture)
     {
-        int gain = captured_value - moving_value;
+        int gain = static_exchange_evaluation(board_representation, move);
 
         int mvv_lva_score = (captured_value * 10) - moving_value;
 
@@ -526,12 +842,12 @@ int compute_move_score(const Move &move, const BoardRepresentation &board_repres
         else if (gain == 0)
         {
             // Equal capture
-            score = 3000 + mvv_lva_score;
+            score = GOOD_CAPTURE_SCORE + mvv_lva_score;
         }
         else // gain < 0
         {
-            // Losing capture
-            score = 2000 - mvv_lva_score;
+            // Losing capture, the smaller the loss the earlier
+            score = 2000 + gain;
         }
     }
     else if (is_promotion)
@@ -539,7 +855,7 @@ int compute_move_score(const Move &move, const BoardRepresentation &board_repres
         // Pawn promotion
         score = 4000;
     }
-    else if (move.is_castle)
+    else if (move.is_castle())
     {
         score = 1500;
     }
@@ -552,7 +868,7 @@ int compute_move_score(const Move &move, const BoardRepresentation &board_repres
     return score;
 }
 
-void sort_for_pruning(std::vector<Move> &move_list, const BoardRepresentation &board_representation)
+void sort_for_pruning(MoveList &move_list, const BoardRepresentation &board_representation)
 {
     std::sort(move_list.begin(), move_list.end(), [&board_representation](const Move &a, const Move &b)
               {
@@ -562,7 +878,7 @@ void sort_for_pruning(std::vector<Move> &move_list, const BoardRepresentation &b
               });
 }
 
-void bump_best_move_to_front(std::vector<Move> &move_list, const Move &best_move)
+void bump_best_move_to_front(MoveList &move_list, const Move &best_move)
 {
     if (!best_move.is_instantiated())
     {
@@ -606,216 +922,66 @@ int get_piece_value(char piece)
     }
 }
 
-int evaluate(BoardRepresentation &board_representation, double remaining_material_ratio)
+int evaluate(BoardRepresentation &board_representation)
 {
-    int eval = 0;
-
-    int our_material_total = 0;
-    int opponent_material_total = 0;
-    std::vector<Square> friendly_pawns, opp_pawns;
-    Square king_pos, opp_king_pos;
+    bool white = board_representation.white_to_move;
+    int eval_modifier = white ? 1 : -1;
+    int material_count = board_representation.material[0] + board_representation.material[1];
 
     // **Material and Positional Evaluation**
-    for (const Square &square : board_representation.non_empty_squares)
+    // Kept incrementally by the board and tapered between the midgame and endgame tables by the material left
+    constexpr int phase_range = MIDGAME_MATERIAL - ENDGAME_MATERIAL;
+    int phase = std::clamp(material_count - ENDGAME_MATERIAL, 0, phase_range);
+    int score = (board_representation.midgame_score * phase +
+                 board_representation.endgame_score * (phase_range - phase)) /
+                phase_range;
+
+    // **Pawn Structure Evaluation**
+    // Looked up by pawn key, so it is only computed again when the pawns change
+    int pawn_score;
+    if (!pawn_hash_table.probe(board_representation.pawn_key, pawn_score))
     {
-        char piece = board_representation.board[square.rank][square.file];
-        bool is_opponent_piece = board_representation.is_opponent_piece(piece);
-        int eval_modifier = is_opponent_piece ? -1 : 1;
-
-        // **Normalize Piece Type**
-        char piece_type = to_lower(piece);
-
-        // **Add Material Value**
-        int material_value = get_piece_value(piece_type);
-        eval += material_value * eval_modifier;
-
-        // **Accumulate Material Totals**
-        if (is_opponent_piece)
-        {
-            opponent_material_total += material_value;
-        }
-        else
-        {
-            our_material_total += material_value;
-        }
-
-        // **Get Positional Value from Piece-Square Table**
-        int position_value = 0;
-        int rank = square.rank;
-        int file = square.file;
-
-        // **Adjust Rank for White Pieces**
-        if (is_white_piece(piece))
-        {
-            rank = 7 - rank;
-        }
-
-        // **Select the Correct Piece-Square Table**
-        switch (piece_type)
-        {
-        case 'p': // Pawn
-            position_value = pawn_piece_square_table[rank][file];
-
-            // **Store Friendly and Opponent Pawn Locations**
-            if (is_opponent_piece)
-            {
-                opp_pawns.push_back(square);
-            }
-            else
-            {
-                friendly_pawns.push_back(square);
-            }
-            break;
-        case 'n': // Knight
-            position_value = knight_piece_square_table[rank][file];
-            break;
-        case 'b': // Bishop
-            position_value = bishop_piece_square_table[rank][file];
-            break;
-        case 'r': // Rook
-            position_value = rook_piece_square_table[rank][file];
-            break;
-        case 'q': // Queen
-            position_value = queen_piece_square_table[rank][file];
-            break;
-        case 'k': // King
-            if (is_opponent_piece)
-            {
-                opp_king_pos = square;
-            }
-            else
-            {
-                king_pos = square;
-            }
-
-            // **King Position Evaluation Based on Game Phase**
-            if (remaining_material_ratio >= EARLY_GAME_MATERIAL_CONDITION)
-            {
-                position_value = king_piece_square_table[rank][file];
-            }
-            else if (remaining_material_ratio <= ENDGAME_MATERIAL_CONDITION)
-            {
-                position_value = king_endgame_piece_square_table[rank][file];
-            }
-            else
-            {
-                double weight_regular = (remaining_material_ratio - ENDGAME_MATERIAL_CONDITION) /
-                                        (EARLY_GAME_MATERIAL_CONDITION - ENDGAME_MATERIAL_CONDITION);
-                double weight_endgame = 1.0 - weight_regular;
-
-                int regular_value = king_piece_square_table[rank][file];
-                int endgame_value = king_endgame_piece_square_table[rank][file];
-
-                position_value = static_cast<int>(
-                    weight_regular * regular_value + weight_endgame * endgame_value + 0.5);
-            }
-            break;
-        default:
-            position_value = 0;
-            break;
-        }
-
-        // **Add Positional Value**
-        eval += position_value * eval_modifier;
+        pawn_score = evaluate_pawn_structure(board_representation.piece_bitboards[WHITE_PAWN],
+                                             board_representation.piece_bitboards[BLACK_PAWN]);
+        pawn_hash_table.store(board_representation.pawn_key, pawn_score);
     }
 
+    int eval = (score + pawn_score) * eval_modifier;
+
     // **Trade Bonus Calculation**
-    int material_difference = our_material_total - opponent_material_total;
-    double trade_bonus = material_difference * (1.0 - remaining_material_ratio) * TRADE_BONUS_FACTOR;
-    eval += static_cast<int>(trade_bonus);
+    int material_difference = board_representation.material[white ? 0 : 1] - board_representation.material[white ? 1 : 0];
+    eval += material_difference * (STARTING_MATERIAL - material_count) / (STARTING_MATERIAL * TRADE_BONUS_DIVISOR);
 
     // **King Safety Evaluation**
-    int king_safety_bonus = 0;
-    if (remaining_material_ratio > 0.5) // If more than half the material is on the board do the additional king safety checks
+    if (2 * material_count > STARTING_MATERIAL) // If more than half the material is on the board do the additional king safety checks
     {
-        king_safety_bonus = evaluate_king_safety(board_representation,
-                                                 remaining_material_ratio,
-                                                 friendly_pawns,
-                                                 opp_pawns,
-                                                 king_pos,
-                                                 opp_king_pos);
+        eval += evaluate_king_safety(board_representation, material_count);
     }
 
-    eval += king_safety_bonus;
-
-    // **Doubled Pawns Evaluation**
-    int doubled_pawns_penalty = evaluate_doubled_pawns(friendly_pawns, opp_pawns);
-    eval += doubled_pawns_penalty;
-
     return eval;
 }
 
-int evaluate_king_safety(const BoardRepresentation &board_representation,
-                         double remaining_material_ratio,
-                         const std::vector<Square> &friendly_pawns,
-                         const std::vector<Square> &opp_pawns,
-                         const Square &king_pos,
-                         const Square &opp_king_pos)
+int evaluate_king_safety(const BoardRepresentation &board_representation, int material_count)
 {
     int white_king_safety_bonus = 0;
     int black_king_safety_bonus = 0;
 
-    const std::vector<Square> &white_pawns = board_representation.white_to_move ? friendly_pawns : opp_pawns;
-    const std::vector<Square> &black_pawns = board_representation.white_to_move ? opp_pawns : friendly_pawns;
-    const Square &white_king = board_representation.white_to_move ? king_pos : opp_king_pos;
-    const Square &black_king = board_representation.white_to_move ? opp_king_pos : king_pos;
-
     // **White King Safety Evaluation**
     if (!board_representation.white_can_castle_kingside &&
         !board_representation.white_can_castle_queenside &&
-        remaining_material_ratio > ENDGAME_MATERIAL_CONDITION)
+        material_count > ENDGAME_MATERIAL)
     {
-        bool white_king_file_open = true;
-
-        for (const Square &pawn : white_pawns)
-        {
-            int distance_to_king = std::max(std::abs(white_king.rank - pawn.rank),
-                                            std::abs(white_king.file - pawn.file));
-
-            if (distance_to_king <= 1)
-            {
-                white_king_safety_bonus += CLOSE_PAWN_BONUS;
-            }
-
-            if (pawn.file == white_king.file)
-            {
-                white_king_file_open = false;
-            }
-        }
-
-        if (white_king_file_open)
-        {
-            white_king_safety_bonus -= OPEN_KING_FILE_PENALTY;
-        }
+        white_king_safety_bonus = king_shelter_bonus(board_representation.piece_bitboards[WHITE_KING],
+                                                     board_representation.piece_bitboards[WHITE_PAWN]);
     }
 
     // **Black King Safety Evaluation**
     if (!board_representation.black_can_castle_kingside &&
         !board_representation.black_can_castle_queenside &&
-        remaining_material_ratio > ENDGAME_MATERIAL_CONDITION)
+        material_count > ENDGAME_MATERIAL)
     {
-        bool black_king_file_open = true;
-
-        for (const Square &pawn : black_pawns)
-        {
-            int distance_to_king = std::max(std::abs(black_king.rank - pawn.rank),
-                                            std::abs(black_king.file - pawn.file));
-
-            if (distance_to_king <= 1)
-            {
-                black_king_safety_bonus += CLOSE_PAWN_BONUS;
-            }
-
-            if (pawn.file == black_king.file)
-            {
-                black_king_file_open = false;
-            }
-        }
-
-        if (black_king_file_open)
-        {
-            black_king_safety_bonus -= OPEN_KING_FILE_PENALTY;
-        }
+        black_king_safety_bonus = king_shelter_bonus(board_representation.piece_bitboards[BLACK_KING],
+                                                     board_representation.piece_bitboards[BLACK_PAWN]);
     }
 
     // **Calculate the King Safety Difference**
@@ -825,32 +991,14 @@ int evaluate_king_safety(const BoardRepresentation &board_representation,
     return king_safety_bonus;
 }
 
-int evaluate_doubled_pawns(const std::vector<Square> &friendly_pawns,
-                           const std::vector<Square> &opp_pawns)
+int evaluate_doubled_pawns(u64 friendly_pawns, u64 opp_pawns)
 {
     int eval = 0;
 
-    // **Initialize Arrays to Count Pawns on Each File**
-    int friendly_pawn_count_by_file[8] = {0};
-    int opponent_pawn_count_by_file[8] = {0};
-
-    // **Count Friendly Pawns on Each File**
-    for (const Square &pawn : friendly_pawns)
-    {
-        friendly_pawn_count_by_file[pawn.file]++;
-    }
-
-    // **Count Opponent Pawns on Each File**
-    for (const Square &pawn : opp_pawns)
-    {
-        opponent_pawn_count_by_file[pawn.file]++;
-    }
-
-    // **Apply Penalties and Bonuses**
     for (int file = 0; file < 8; ++file)
     {
-        int friendly_pawns_on_file = friendly_pawn_count_by_file[file];
-        int opponent_pawns_on_file = opponent_pawn_count_by_file[file];
+        int friendly_pawns_on_file = count_bits(friendly_pawns & (FILE_A << file));
+        int opponent_pawns_on_file = count_bits(opp_pawns & (FILE_A << file));
 
         // **Penalty for Doubled Friendly Pawns**
         if (friendly_pawns_on_file > 1)
@@ -867,3 +1015,45 @@ int evaluate_doubled_pawns(const std::vector<Square> &friendly_pawns,
 
     return eval;
 }
+
+int evaluate_pawn_structure(u64 white_pawns, u64 black_pawns)
+{
+    int eval = evaluate_doubled_pawns(white_pawns, black_pawns);
+
+    for (int side = 0; side < 2; ++side)
+    {
+        bool white = side == 0;
+        u64 friendly_pawns = white ? white_pawns : black_pawns;
+        u64 opp_pawns = white ? black_pawns : white_pawns;
+        int side_eval = 0;
+
+        u64 pawns = friendly_pawns;
+        while (pawns)
+        {
+            int square = pop_LSB(pawns);
+            int rank = square / 8;
+            int file = square % 8;
+            u64 file_mask = FILE_A << file;
+            u64 adjacent_files = ((file_mask << 1) & ~FILE_A) | ((file_mask >> 1) & ~FILE_H);
+
+            // **Penalty for Isolated Pawns**
+            if (!(friendly_pawns & adjacent_files))
+            {
+                side_eval -= ISOLATED_PAWN_PENALTY;
+            }
+
+            // **Bonus for Passed Pawns**
+            // No opponent pawn ahead on its own or a neighbouring file
+            u64 ranks_ahead = white ? (rank == 7 ? 0ULL : ~0ULL << (8 * (rank + 1)))
+                                    : (1ULL << (8 * rank)) - 1;
+            if (!(opp_pawns & (file_mask | adjacent_files) & ranks_ahead))
+            {
+                side_eval += PASSED_PAWN_BONUS[white ? rank : 7 - rank];
+            }
+        }
+
+        eval += white ? side_eval : -side_eval;
+    }
+
+    return eval;
+}
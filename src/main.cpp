@@ -1,7 +1,10 @@
 #include "board_representation.h"
 #include "evaluation.h"
 #include "zobrist_values.h"
+#include "attack_tables.h"
 #include "transposition_table.h"
+#include "search_controller.h"
+#include "bench.h"
 
 #include <iostream>
 #include <sstream>
@@ -23,72 +26,55 @@ std::vector<std::string> split(const std::string &str, char delimiter)
   return tokens;
 }
 
-// Helper function to stop and join the pondering thread
-void stopPondering(std::thread &ponder_thread,
-                   std::atomic<bool> &stop_condition,
-                   ThreadSafeLogger &logger)
+// Main function to handle UCI communication, or "main bench [depth]" to run the bench and exit
+int main(int argc, char *argv[])
 {
-  if (ponder_thread.joinable())
-  {
-    logger.write("Debug", "Stopping pondering thread...");
-    stop_condition = true; // Signal the thread to stop
-
-    auto start_time = std::chrono::steady_clock::now();
-
-    // Join the thread to ensure it has finished execution
-    ponder_thread.join();
+  init_zobrist_keys(); // To be down once at start of program
+  init_attack_tables();
 
-    std::ostringstream oss;
-    oss << "Pondering thread stopped in "
-        << std::chrono::duration_cast<std::chrono::milliseconds>(
-               std::chrono::steady_clock::now() - start_time)
-               .count()
-        << " ms";
-    logger.write("Debug", oss.str());
+  if (argc > 1 && std::string(argv[1]) == "bench")
+  {
+    run_bench(std::cout, argc > 2 ? std::stoi(argv[2]) : BENCH_DEPTH);
+    return 0;
   }
-}
 
-// Main function to handle UCI communication
-int main()
-{
-  init_zobrist_keys(); // To be down once at start of program
   BoardRepresentation board_representation;
   std::string input;
-  Move best_move, ponder_move;
-
-  // Pondering thread control
-  std::thread ponder_thread;
-  std::atomic<bool> hard_stop_pondering(false);
-  std::atomic<bool> ponder_hit(false);
-  std::mutex ponder_mutex;
-  Move next_ponder_move, best_move_pondered;
 
   ThreadSafeLogger &logger = ThreadSafeLogger::getInstance("logs/app_log.txt");
 
   // Init transposition table
   TranspositionTable transposition_table;
 
+  // Searches run on their own thread so this loop can answer "stop" and "isready" meanwhile
+  SearchController search_controller(std::cout);
+
   try
   {
     while (true)
     {
-      std::getline(std::cin, input);
+      if (!std::getline(std::cin, input))
+        break; // GUI closed the pipe
       if (input.empty())
         continue;
 
       logger.write("Input", input);
       std::vector<std::string> tokens = split(input, ' ');
 
-      // Stop pondering for all commands except "ponderhit" or "stop"
-      if (tokens[0] != "ponderhit" && tokens[0] != "stop")
+      // Abandon a running search only for commands that replace it or change what it works on.
+      // Anything else, including input we do not recognise, leaves it running
+      if (tokens[0] == "position" || tokens[0] == "go" || tokens[0] == "ucinewgame" ||
+          tokens[0] == "setoption" || tokens[0] == "bench" || tokens[0] == "quit")
       {
-        stopPondering(ponder_thread, hard_stop_pondering, logger);
+        search_controller.abort();
       }
 
       if (tokens[0] == "uci")
       {
-        std::cout << "uciok" << std::endl;
-        logger.write("Output", "uciok");
+        search_controller.send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) +
+                               " min 1 max " + std::to_string(MAX_HASH_MB));
+        search_controller.send("option name Threads type spin default 1 min 1 max " + std::to_string(MAX_SEARCH_THREADS));
+        search_controller.send("uciok");
       }
       if (tokens[0] == "ucinewgame")
       {
@@ -98,8 +84,26 @@ int main()
       }
       else if (tokens[0] == "isready")
       {
-        std::cout << "readyok" << std::endl;
-        logger.write("Output", "readyok");
+        search_controller.send("readyok");
+      }
+      else if (tokens[0] == "setoption")
+      {
+        // setoption name Hash value <megabytes>
+        if (tokens.size() >= 5 && tokens[1] == "name" && tokens[2] == "Hash" && tokens[3] == "value")
+        {
+          transposition_table.resize(std::stoul(tokens[4]));
+          logger.write("Debug", "Transposition table resized to " + std::to_string(transposition_table.size_in_bytes()) + " bytes");
+        }
+        // setoption name Threads value <count>
+        else if (tokens.size() >= 5 && tokens[1] == "name" && tokens[2] == "Threads" && tokens[3] == "value")
+        {
+          search_controller.set_threads(std::stoi(tokens[4]));
+          logger.write("Debug", "Searching with " + tokens[4] + " threads");
+        }
+        else
+        {
+          logger.write("Warning", "Unknown option");
+        }
       }
       else if (tokens[0] == "position")
       {
@@ -147,6 +151,23 @@ int main()
           logger.write("Error", "Invalid position command");
         }
       }
+      else if (tokens[0] == "bench")
+      {
+        // bench [depth], searches the fixed bench positions and reports the node count signature
+        search_controller.go_bench(tokens.size() > 1 ? std::stoi(tokens[1]) : BENCH_DEPTH);
+      }
+      else if (tokens[0] == "go" && tokens.size() > 2 && tokens[1] == "perft")
+      {
+        search_controller.go_perft(board_representation, std::stoi(tokens[2]));
+      }
+      else if (tokens[0] == "go" && tokens.size() > 2 && tokens[1] == "depth")
+      {
+        search_controller.go_depth(board_representation, transposition_table, std::stoi(tokens[2]));
+      }
+      else if (tokens[0] == "go" && tokens.size() > 1 && tokens[1] == "infinite")
+      {
+        search_controller.go_infinite(board_representation, transposition_table);
+      }
       else if (tokens[0] == "go" && (tokens.size() == 1 || tokens[1] != "ponder"))
       {
         int wtime = 30000, btime = 30000, winc = 0, binc = 0;
@@ -173,44 +194,12 @@ int main()
           forced_time = -1;
         }
 
-        Evaluation position_evaluation =
-            find_best_move(board_representation, transposition_table, true,
-                           wtime, btime, winc, binc,
-                           forced_time);
-
-        best_move = position_evaluation.best_move;
-        ponder_move = position_evaluation.ponder_move;
-
-        if (!best_move.is_instantiated())
-        {
-          throw std::runtime_error("Best move not instantiated");
-        }
-
-        if (ponder_move.is_instantiated())
-        {
-          std::cout << "bestmove " << best_move.to_UCI()
-                    << " ponder " << ponder_move.to_UCI() << std::endl;
-          std::ostringstream oss;
-          oss << "bestmove " << best_move.to_UCI()
-              << " ponder " << ponder_move.to_UCI();
-          logger.write("Output", oss.str());
-        }
-        else
-        {
-          std::cout << "bestmove " << best_move.to_UCI() << std::endl;
-          std::ostringstream oss;
-          oss << "bestmove " << best_move.to_UCI();
-          logger.write("Output", oss.str());
-        }
-
-        // maintain the transposition table
-        transposition_table.maintain_table();
+        search_controller.go(board_representation, transposition_table,
+                             wtime, btime, winc, binc,
+                             forced_time);
       }
       else if (tokens[0] == "go" && tokens[1] == "ponder")
       {
-        ponder_hit = false;
-        hard_stop_pondering = false;
-
         // Parse time arguments similarly to the normal 'go' command
         // Format: go ponder wtime <int> btime <int> [winc <int> binc <int>]
         int wtime = 30000, btime = 30000, winc = 0, binc = 0;
@@ -243,55 +232,17 @@ int main()
 
         logger.write("Debug", "Started pondering.");
 
-        ponder_thread = std::thread(ponder,
-                                    std::ref(board_representation),
-                                    std::ref(transposition_table),
-                                    std::ref(next_ponder_move),
-                                    std::ref(best_move_pondered),
-                                    true,
-                                    std::cref(ponder_hit),
-                                    std::cref(hard_stop_pondering),
-                                    wtime,
-                                    btime,
-                                    winc,
-                                    binc,
+        search_controller.go_ponder(board_representation, transposition_table,
+                                    wtime, btime, winc, binc,
                                     forced_time);
       }
-      else if (tokens[0] == "ponderhit" || tokens[0] == "stop")
+      else if (tokens[0] == "ponderhit")
       {
-        std::atomic<bool> &stop_condition = (tokens[0] == "ponderhit") ? ponder_hit : hard_stop_pondering;
-        stopPondering(ponder_thread, stop_condition, logger);
-
-        {
-          std::lock_guard<std::mutex> lock(ponder_mutex);
-          best_move = best_move_pondered;
-          ponder_move = next_ponder_move;
-        }
-
-        if (!best_move.is_instantiated())
-        {
-          throw std::runtime_error("Best move not instantiated");
-        }
-
-        if (ponder_move.is_instantiated())
-        {
-          std::cout << "bestmove " << best_move.to_UCI()
-                    << " ponder " << ponder_move.to_UCI() << std::endl;
-          std::ostringstream oss;
-          oss << "bestmove " << best_move.to_UCI()
-              << " ponder " << ponder_move.to_UCI();
-          logger.write("Output", oss.str());
-        }
-        else
-        {
-          std::cout << "bestmove " << best_move.to_UCI() << std::endl;
-          std::ostringstream oss;
-          oss << "bestmove " << best_move.to_UCI();
-          logger.write("Output", oss.str());
-        }
-
-        // maintain the transposition table
-        transposition_table.maintain_table();
+        search_controller.on_ponder_hit();
+      }
+      else if (tokens[0] == "stop")
+      {
+        search_controller.stop();
       }
       else if (tokens[0] == "quit")
       {
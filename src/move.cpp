@@ -4,11 +4,15 @@
 std::string Move::to_UCI() const
 {
 
-    if (!start_square.exists() || !to_square.exists())
+    if (!is_instantiated())
     {
         throw std::runtime_error("Move not initialized");
     }
 
+    Square start_square = this->start_square();
+    Square to_square = this->to_square();
+    char promotion_piece = this->promotion_piece();
+
     std::string uci;
     uci += static_cast<char>('a' + start_square.file); // Convert file to character ('a' to 'h')
     uci += static_cast<char>('1' + start_square.rank); // Convert rank to character ('1' to '8')
@@ -1,864 +1,303 @@
 #include "move_generator.h"
 
-void generate_pawn_move(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    const Square &on_square,
-    std::vector<SquareToSquareMap> &attacked_squares)
+// Push a move to every square of a target bitboard
+inline void add_moves(MoveList &move_list, int from_square, u64 targets)
 {
-    int8_t rank = on_square.rank;
-    int8_t file = on_square.file;
+    while (targets)
+    {
+        move_list.push_back(Move(from_square, pop_LSB(targets)));
+    }
+}
+
+void generate_pawn_moves(
+    const BoardRepresentation &board_representation,
+    MoveList &move_list,
+    int from_square,
+    u64 allowed_squares,
+    bool only_captures)
+{
+    bool is_white = board_representation.white_to_move;
+    int direction = is_white ? 8 : -8; // Up for white, down for black
+    u64 enemy = is_white ? board_representation.black_pieces : board_representation.white_pieces;
+    u64 promotion_rank = is_white ? RANK_8 : RANK_1;
 
-    int8_t direction = board_representation.white_to_move ? 1 : -1; // Up for white, down for black
+    // Captures
+    u64 targets = PAWN_ATTACKS[is_white ? 0 : 1][from_square] & enemy;
 
-    // if opponents piece determine attacked squares
-    if (board_representation.is_opponent_piece(board_representation.board[rank][file]))
+    // Forward moves onto empty squares
+    if (!only_captures)
     {
-        if (file + 1 <= 7)
+        int next_square = from_square + direction;
+        if (!(board_representation.occupied & (1ULL << next_square)))
         {
-            attacked_squares.push_back(SquareToSquareMap(Square(rank - direction, file + 1), Square(rank, file)));
-        }
-        if (file - 1 >= 0)
-        {
-            attacked_squares.push_back(SquareToSquareMap(Square(rank - direction, file - 1), Square(rank, file)));
-        }
+            targets |= 1ULL << next_square;
 
-        return; // don't generate any real moves if not turn
+            // Double move from starting position, both squares must be empty
+            u64 starting_rank = is_white ? RANK_2 : RANK_7;
+            int double_move_square = next_square + direction;
+            if ((starting_rank & (1ULL << from_square)) && !(board_representation.occupied & (1ULL << double_move_square)))
+            {
+                targets |= 1ULL << double_move_square;
+            }
+        }
     }
 
-    int8_t promotion_rank = board_representation.white_to_move ? 7 : 0;
+    targets &= allowed_squares;
 
-    // Forward move
-    int8_t next_rank = rank + direction;
-    if (next_rank >= 0 && next_rank <= 7 && board_representation.board[next_rank][file] == 'e') // if square in front is empty
+    while (targets)
     {
-        if (next_rank == promotion_rank)
+        int to_square = pop_LSB(targets);
+
+        if (promotion_rank & (1ULL << to_square))
         {
             // Generate promotion moves
             char promotion_pieces[] = {'q', 'r', 'b', 'n'}; // Promote to queen, rook, bishop, or knight
             for (char promo_piece : promotion_pieces)
             {
-                move_list.push_back(Move(on_square, Square(next_rank, file), false, false, promo_piece));
+                move_list.push_back(Move(from_square, to_square, PROMOTION, promo_piece));
             }
         }
         else
         {
-            move_list.push_back(Move(on_square, Square(next_rank, file)));
-
-            // Double move from starting position
-            bool is_starting_rank = (board_representation.white_to_move && rank == 1) ||
-                                    (!board_representation.white_to_move && rank == 6);
-            int8_t double_move_rank = static_cast<int8_t>(rank + 2 * direction);
-            if (is_starting_rank && board_representation.board[double_move_rank][file] == 'e' &&
-                board_representation.board[next_rank][file] == 'e') // Both squares must be empty
-            {
-                move_list.push_back(Move(on_square, Square(double_move_rank, file)));
-            }
+            move_list.push_back(Move(from_square, to_square));
         }
     }
 
-    // Captures (including en passant)
-    for (int8_t delta_file = -1; delta_file <= 1; delta_file += 2)
+    // En passant capture (never part of the captures only list since the target square is empty)
+    const Square &en_passant_square = board_representation.en_passant_square;
+    if (only_captures || !en_passant_square.exists())
     {
-        int8_t capture_file = file + delta_file;
-        if (capture_file >= 0 && capture_file < 8)
-        {
-            int8_t target_rank = rank + direction;
-            char target_piece = board_representation.board[target_rank][capture_file];
-
-            // Normal capture
-            if (target_piece != 'e' && board_representation.is_opponent_piece(target_piece))
-            {
-                if (target_rank == promotion_rank)
-                {
-                    // Promotion capture
-                    char promotion_pieces[] = {'q', 'r', 'b', 'n'};
-                    for (char promo_piece : promotion_pieces)
-                    {
-                        move_list.push_back(Move(on_square, Square(target_rank, capture_file), false, false, promo_piece));
-                    }
-                }
-                else
-                {
-                    move_list.push_back(Move(on_square, Square(target_rank, capture_file)));
-                }
-            }
-            // En passant capture
-            else
-            {
-                Square &en_passant_square = board_representation.en_passant_square;
-                if (en_passant_square.rank == target_rank && en_passant_square.file == capture_file)
-                {
-                    move_list.push_back(Move(on_square, Square(target_rank, capture_file), true, false, 'x'));
-                }
-            }
-        }
+        return;
     }
-}
 
-void generate_rook_move(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    const Square &on_square,
-    std::vector<SquareToSquareMap> &attacked_squares)
-
-{
-    int8_t rank = on_square.rank;
-    int8_t file = on_square.file;
-
-    // Rook movement directions: up, down, left, right
-    constexpr int8_t directions[4][2] = {
-        {-1, 0}, // Down
-        {1, 0},  // Up
-        {0, -1}, // Left
-        {0, 1}   // Right
-    };
-
-    bool generating_attacked_squares = board_representation.is_opponent_piece(board_representation.board[rank][file]);
-
-    // Iterate over each direction
-    for (int8_t i = 0; i < 4; ++i)
+    int en_passant_index = en_passant_square.to_index();
+    if (!(PAWN_ATTACKS[is_white ? 0 : 1][from_square] & (1ULL << en_passant_index)))
     {
-        int8_t delta_rank = directions[i][0];
-        int8_t delta_file = directions[i][1];
-
-        int8_t current_rank = rank + delta_rank;
-        int8_t current_file = file + delta_file;
-
-        // Move along the direction until the edge of the board or a blocking piece
-        while (current_rank >= 0 && current_rank <= 7 && current_file >= 0 && current_file <= 7)
-        {
-            char target_piece = board_representation.board[current_rank][current_file];
-
-            if (target_piece == 'e')
-            {
-                if (!generating_attacked_squares)
-                {
-                    // Empty square, rook can move here
-                    move_list.push_back(Move(on_square, Square(current_rank, current_file)));
-                }
-                else
-                {
-                    attacked_squares.push_back(SquareToSquareMap(Square(current_rank, current_file), Square(rank, file)));
-                }
-            }
-            else if (board_representation.is_opponent_piece(target_piece))
-            {
-                if (!generating_attacked_squares)
-                {
-                    // Empty square, rook can move here
-                    move_list.push_back(Move(on_square, Square(current_rank, current_file)));
-                }
-                else
-                {
-                    attacked_squares.push_back(SquareToSquareMap(Square(current_rank, current_file), Square(rank, file)));
-                }
-                break; // Cannot move past capturing a piece
-            }
-            else
-            {
-                if (generating_attacked_squares)
-                {
-                    attacked_squares.push_back(SquareToSquareMap(Square(current_rank, current_file), Square(rank, file)));
-                }
-                // Own piece blocks further movement
-                break;
-            }
-
-            // Move to the next square in the same direction
-            current_rank += delta_rank;
-            current_file += delta_file;
-        }
+        return;
     }
-}
-
-void generate_bishop_move(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    const Square &on_square,
-    std::vector<SquareToSquareMap> &attacked_squares)
-{
-    int8_t rank = on_square.rank;
-    int8_t file = on_square.file;
 
-    bool generating_attacked_squares = board_representation.is_opponent_piece(board_representation.board[rank][file]);
-
-    // Bishop movement directions: four diagonals
-    constexpr int8_t directions[4][2] = {
-        {-1, -1}, // Up-left
-        {-1, 1},  // Up-right
-        {1, -1},  // Down-left
-        {1, 1}    // Down-right
-    };
+    // Two pawns leave the board and one lands, so pins and checks are resolved by looking at the
+    // king's attackers on the resulting occupancy instead of the pin and check masks
+    u64 captured_pawn = 1ULL << (en_passant_index - direction);
+    u64 occupied_after = (board_representation.occupied ^ (1ULL << from_square) ^ captured_pawn) | (1ULL << en_passant_index);
+    u64 king = board_representation.piece_bitboards[is_white ? WHITE_KING : BLACK_KING];
 
-    // Iterate over each direction
-    for (int8_t i = 0; i < 4; ++i)
+    if (!(attackers_to(board_representation, get_LSB_index(king), occupied_after) & enemy & ~captured_pawn))
     {
-        int8_t delta_rank = directions[i][0];
-        int8_t delta_file = directions[i][1];
-
-        int8_t current_rank = rank + delta_rank;
-        int8_t current_file = file + delta_file;
-
-        // Move along the direction until the edge of the board or a blocking piece
-        while (current_rank >= 0 && current_rank <= 7 && current_file >= 0 && current_file <= 7)
-        {
-            char target_piece = board_representation.board[current_rank][current_file];
-
-            if (target_piece == 'e')
-            {
-                if (!generating_attacked_squares)
-                {
-                    // Empty square, rook can move here
-                    move_list.push_back(Move(on_square, Square(current_rank, current_file)));
-                }
-                else
-                {
-                    attacked_squares.push_back(SquareToSquareMap(Square(current_rank, current_file), Square(rank, file)));
-                }
-            }
-            else if (board_representation.is_opponent_piece(target_piece))
-            {
-                if (!generating_attacked_squares)
-                {
-                    // Empty square, rook can move here
-                    move_list.push_back(Move(on_square, Square(current_rank, current_file)));
-                }
-                else
-                {
-                    attacked_squares.push_back(SquareToSquareMap(Square(current_rank, current_file), Square(rank, file)));
-                }
-                break; // Cannot move past capturing a piece
-            }
-            else
-            {
-                if (generating_attacked_squares)
-                {
-                    attacked_squares.push_back(SquareToSquareMap(Square(current_rank, current_file), Square(rank, file)));
-                }
-                // Own piece blocks further movement
-                break;
-            }
-
-            // Move to the next square in the same direction
-            current_rank += delta_rank;
-            current_file += delta_file;
-        }
+        move_list.push_back(Move(from_square, en_passant_index, EN_PASSANT));
     }
 }
 
-void generate_knight_move(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    const Square &on_square,
-    std::vector<SquareToSquareMap> &attacked_squares)
+void generate_castle(const BoardRepresentation &board_representation, MoveList &move_list)
 {
-    int8_t rank = on_square.rank;
-    int8_t file = on_square.file;
-
-    // Possible knight moves relative to the current position
-    constexpr int8_t knight_moves[8][2] = {
-        {-2, -1}, // 2 up, 1 left
-        {-2, 1},  // 2 up, 1 right
-        {-1, -2}, // 1 up, 2 left
-        {-1, 2},  // 1 up, 2 right
-        {1, -2},  // 1 down, 2 left
-        {1, 2},   // 1 down, 2 right
-        {2, -1},  // 2 down, 1 left
-        {2, 1}    // 2 down, 1 right
-    };
-
-    // Iterate over all possible knight moves
-    for (int8_t i = 0; i < 8; ++i)
+    // Determine the side to move
+    bool is_white = board_representation.white_to_move;
+    bool can_castle_kingside = is_white ? board_representation.white_can_castle_kingside : board_representation.black_can_castle_kingside;
+    bool can_castle_queenside = is_white ? board_representation.white_can_castle_queenside : board_representation.black_can_castle_queenside;
+
+    // King's starting position on the e file
+    int king_square = is_white ? 4 : 60;
+    const u64 &occupied = board_representation.occupied;
+
+    // Squares between king and rook must be empty and the king may not pass through or land on an attacked square
+    // (the caller only generates castles when the king is not in check)
+    if (can_castle_kingside &&
+        !(occupied & (3ULL << (king_square + 1))) &&
+        !is_square_attacked_by(board_representation, king_square + 1, !is_white) &&
+        !is_square_attacked_by(board_representation, king_square + 2, !is_white))
     {
-        int8_t new_rank = rank + knight_moves[i][0];
-        int8_t new_file = file + knight_moves[i][1];
-
-        // Check if the new position is within the board boundaries
-        if (new_rank >= 0 && new_rank <= 7 && new_file >= 0 && new_file <= 7)
-        {
-            char target_piece = board_representation.board[new_rank][new_file];
-
-            // generate attacked squares
-            if (board_representation.is_opponent_piece(board_representation.board[rank][file]))
-            {
-                attacked_squares.push_back(SquareToSquareMap(Square(new_rank, new_file), Square(rank, file)));
-            }
-            // Check if the square is empty or contains an opponent's piece
-            else if (target_piece == 'e' || board_representation.is_opponent_piece(target_piece))
-            {
-                // Add the move to the move list
-                move_list.push_back(Move(on_square, Square(new_rank, new_file)));
-            }
-            // If it's our own piece, the knight cannot move there
-        }
+        move_list.push_back(Move(king_square, king_square + 2, CASTLE));
     }
-}
-
-void generate_queen_move(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    const Square &on_square,
-    std::vector<SquareToSquareMap> &attacked_squares)
-{
-    int8_t rank = on_square.rank;
-    int8_t file = on_square.file;
-
-    bool generating_attacked_squares = board_representation.is_opponent_piece(board_representation.board[rank][file]);
-
-    // Queen movement directions: combination of rook and bishop directions
-    constexpr int8_t directions[8][2] = {
-        {-1, 0},  // Up
-        {1, 0},   // Down
-        {0, -1},  // Left
-        {0, 1},   // Right
-        {-1, -1}, // Up-left
-        {-1, 1},  // Up-right
-        {1, -1},  // Down-left
-        {1, 1}    // Down-right
-    };
 
-    // Iterate over each direction
-    for (int8_t i = 0; i < 8; ++i)
+    if (can_castle_queenside &&
+        !(occupied & (7ULL << (king_square - 3))) &&
+        !is_square_attacked_by(board_representation, king_square - 1, !is_white) &&
+        !is_square_attacked_by(board_representation, king_square - 2, !is_white))
     {
-        int8_t delta_rank = directions[i][0];
-        int8_t delta_file = directions[i][1];
-
-        int8_t current_rank = rank + delta_rank;
-        int8_t current_file = file + delta_file;
-
-        // Move along the direction until the edge of the board or a blocking piece
-        while (current_rank >= 0 && current_rank <= 7 && current_file >= 0 && current_file <= 7)
-        {
-            char target_piece = board_representation.board[current_rank][current_file];
-
-            if (target_piece == 'e')
-            {
-                if (!generating_attacked_squares)
-                {
-                    // Empty square, rook can move here
-                    move_list.push_back(Move(on_square, Square(current_rank, current_file)));
-                }
-                else
-                {
-                    attacked_squares.push_back(SquareToSquareMap(Square(current_rank, current_file), Square(rank, file)));
-                }
-            }
-            else if (board_representation.is_opponent_piece(target_piece))
-            {
-                if (!generating_attacked_squares)
-                {
-                    // Empty square, rook can move here
-                    move_list.push_back(Move(on_square, Square(current_rank, current_file)));
-                }
-                else
-                {
-                    attacked_squares.push_back(SquareToSquareMap(Square(current_rank, current_file), Square(rank, file)));
-                }
-                break; // Cannot move past capturing a piece
-            }
-            else
-            {
-                if (generating_attacked_squares)
-                {
-                    attacked_squares.push_back(SquareToSquareMap(Square(current_rank, current_file), Square(rank, file)));
-                }
-                // Own piece blocks further movement
-                break;
-            }
-
-            // Move to the next square in the same direction
-            current_rank += delta_rank;
-            current_file += delta_file;
-        }
+        move_list.push_back(Move(king_square, king_square - 2, CASTLE));
     }
 }
 
-void generate_king_move(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    const Square &on_square,
-    std::vector<SquareToSquareMap> &attacked_squares)
+u64 attackers_to(const BoardRepresentation &board_representation, int square, u64 occupied)
 {
-    int8_t rank = on_square.rank;
-    int8_t file = on_square.file;
-
-    // King movement directions: one square in any direction
-    constexpr int8_t directions[8][2] = {
-        {-1, 0},  // Up
-        {1, 0},   // Down
-        {0, -1},  // Left
-        {0, 1},   // Right
-        {-1, -1}, // Up-left
-        {-1, 1},  // Up-right
-        {1, -1},  // Down-left
-        {1, 1}    // Down-right
-    };
-
-    // Iterate over all possible directions
-    for (int8_t i = 0; i < 8; ++i)
-    {
-        int8_t new_rank = rank + directions[i][0];
-        int8_t new_file = file + directions[i][1];
-
-        // Check if the new position is within the board boundaries
-        if (new_rank >= 0 && new_rank <= 7 && new_file >= 0 && new_file <= 7)
-        {
-            char target_piece = board_representation.board[new_rank][new_file];
+    const u64 *bitboards = board_representation.piece_bitboards;
+    u64 rooks_queens = bitboards[WHITE_ROOK] | bitboards[WHITE_QUEEN] | bitboards[BLACK_ROOK] | bitboards[BLACK_QUEEN];
+    u64 bishops_queens = bitboards[WHITE_BISHOP] | bitboards[WHITE_QUEEN] | bitboards[BLACK_BISHOP] | bitboards[BLACK_QUEEN];
+
+    // A white pawn attacks this square from the squares a black pawn would attack and vice versa
+    return (PAWN_ATTACKS[1][square] & bitboards[WHITE_PAWN]) |
+           (PAWN_ATTACKS[0][square] & bitboards[BLACK_PAWN]) |
+           (KNIGHT_ATTACKS[square] & (bitboards[WHITE_KNIGHT] | bitboards[BLACK_KNIGHT])) |
+           (KING_ATTACKS[square] & (bitboards[WHITE_KING] | bitboards[BLACK_KING])) |
+           (rook_attacks(square, occupied) & rooks_queens) |
+           (bishop_attacks(square, occupied) & bishops_queens);
+}
 
-            // generate attacked squares
-            if (board_representation.is_opponent_piece(board_representation.board[rank][file]))
-            {
-                attacked_squares.push_back(SquareToSquareMap(Square(new_rank, new_file), Square(rank, file)));
-            }
-            // Check if the square is empty or contains an opponent's piece
-            else if (target_piece == 'e' || board_representation.is_opponent_piece(target_piece))
-            {
-                // Add the move to the move list
-                move_list.push_back(Move(on_square, Square(new_rank, new_file)));
-            }
-            // If it's our own piece, the king cannot move there
-        }
-    }
+bool is_square_attacked_by(const BoardRepresentation &board_representation, int square, bool by_white)
+{
+    u64 attackers = by_white ? board_representation.white_pieces : board_representation.black_pieces;
+    return (attackers_to(board_representation, square, board_representation.occupied) & attackers) != 0;
 }
 
-void generate_castle(BoardRepresentation &board_representation, std::vector<Move> &move_list)
+u64 get_pinned_pieces(const BoardRepresentation &board_representation, int king_square)
 {
-    // Determine the side to move
+    const u64 *bitboards = board_representation.piece_bitboards;
     bool is_white = board_representation.white_to_move;
+    u64 friendly = is_white ? board_representation.white_pieces : board_representation.black_pieces;
+    u64 enemy = is_white ? board_representation.black_pieces : board_representation.white_pieces;
+    int enemy_offset = is_white ? BLACK_PAWN : WHITE_PAWN;
 
-    // King's starting position
-    int8_t king_rank = is_white ? 0 : 7;
-    int8_t king_file = 4; // 'e' file
+    // Enemy sliders that would attack the king if friendly pieces were transparent
+    u64 snipers = (rook_attacks(king_square, enemy) & (bitboards[enemy_offset + 3] | bitboards[enemy_offset + 4])) |
+                  (bishop_attacks(king_square, enemy) & (bitboards[enemy_offset + 2] | bitboards[enemy_offset + 4]));
 
-    // Castling rights and conditions
-    if (is_white)
+    u64 pinned = 0ULL;
+    while (snipers)
     {
-        // White's kingside castling
-        if (board_representation.white_can_castle_kingside)
+        u64 blockers = BETWEEN[king_square][pop_LSB(snipers)] & board_representation.occupied;
+        if (count_bits(blockers) == 1 && (blockers & friendly))
         {
-            // Check if squares between king and rook are empty
-            if (board_representation.board[king_rank][5] == 'e' &&
-                board_representation.board[king_rank][6] == 'e')
-            {
-                // Create the castling move (king moves from e1 to g1)
-                move_list.push_back(Move(Square(king_rank, king_file), Square(king_rank, 6), false, true));
-            }
-        }
-
-        // White's queenside castling
-        if (board_representation.white_can_castle_queenside)
-        {
-            // Check if squares between king and rook are empty
-            if (board_representation.board[king_rank][3] == 'e' &&
-                board_representation.board[king_rank][2] == 'e' &&
-                board_representation.board[king_rank][1] == 'e')
-            {
-                // Create the castling move (king moves from e1 to c1)
-                move_list.push_back(Move(Square(king_rank, king_file), Square(king_rank, 2), false, true));
-            }
-        }
-    }
-    else
-    {
-        // Black's kingside castling
-        if (board_representation.black_can_castle_kingside)
-        {
-            // Check if squares between king and rook are empty
-            if (board_representation.board[king_rank][5] == 'e' &&
-                board_representation.board[king_rank][6] == 'e')
-            {
-                // Create the castling move (king moves from e8 to g8)
-                move_list.push_back(Move(Square(king_rank, king_file), Square(king_rank, 6), false, true));
-            }
-        }
-
-        // Black's queenside castling
-        if (board_representation.black_can_castle_queenside)
-        {
-            // Check if squares between king and rook are empty
-            if (board_representation.board[king_rank][3] == 'e' &&
-                board_representation.board[king_rank][2] == 'e' &&
-                board_representation.board[king_rank][1] == 'e')
-            {
-                // Create the castling move (king moves from e8 to c8)
-                move_list.push_back(Move(Square(king_rank, king_file), Square(king_rank, 2), false, true));
-            }
+            pinned |= blockers;
         }
     }
+    return pinned;
 }
 
-void generate_pseudo_legal_moves(
-    BoardRepresentation &board_representation,
-    std::vector<Move> &move_list,
-    std::vector<SquareToSquareMap> &attacked_squares,
-    Square &king_position)
+namespace
 {
-    for (const Square &current_square : board_representation.non_empty_squares)
+    // Stores every legal move
+    struct MoveCollector
     {
+        MoveList &move_list;
 
-        char piece = board_representation.board[current_square.rank][current_square.file];
-
-        // Convert piece to lowercase for uniformity in switch
-        char piece_type = to_lower(piece);
+        explicit MoveCollector(MoveList &move_list_) : move_list(move_list_) {}
 
-        if (piece_type == 'e')
-        {
-            throw std::runtime_error("Empty square in non-empty squares.");
-        }
-
-        // Call the appropriate move generator based on the piece type
-        switch (piece_type)
-        {
-        case 'p': // Pawn
-            generate_pawn_move(
-                board_representation,
-                move_list,
-                current_square,
-                attacked_squares);
-            break;
-
-        case 'n': // Knight
-            generate_knight_move(
-                board_representation,
-                move_list,
-                current_square,
-                attacked_squares);
-            break;
-
-        case 'b': // Bishop
-            generate_bishop_move(
-                board_representation,
-                move_list,
-                current_square,
-                attacked_squares);
-            break;
-
-        case 'r': // Rook
-            generate_rook_move(
-                board_representation,
-                move_list,
-                current_square,
-                attacked_squares);
-            break;
-
-        case 'q': // Queen
-            generate_queen_move(
-                board_representation,
-                move_list,
-                current_square,
-                attacked_squares);
-            break;
-
-        case 'k': // King
-            if (!board_representation.is_opponent_piece(board_representation.board[current_square.rank][current_square.file]))
-            {
-                // store friendly king location
-                king_position = current_square;
-            }
-            generate_king_move(
-                board_representation,
-                move_list,
-                current_square,
-                attacked_squares);
-            break;
-        }
-    }
+        void add_targets(int from_square, u64 targets) { add_moves(move_list, from_square, targets); }
+        MoveList &irregular_moves() { return move_list; }
+        u64 total() const { return static_cast<u64>(move_list.size()); }
+    };
 
-    generate_castle(board_representation, move_list);
-}
+    // Counts moves off their target bitboards, only pawn moves and castles are listed
+    struct MoveCounter
+    {
+        MoveList special_moves;
+        u64 count;
 
-// Function to count occurrences of a Square in the 'attacked' field
-bool is_square_attacked(const std::vector<SquareToSquareMap> &maps, const Square &target_square)
-{
-    return std::any_of(maps.begin(), maps.end(), [&](const SquareToSquareMap &map)
-                       { return map.attacked == target_square; });
-}
+        MoveCounter() : special_moves(), count(0) {}
 
-int count_square_attacks(const std::vector<SquareToSquareMap> &maps, const Square &target_square)
-{
-    return static_cast<int8_t>(std::count_if(maps.begin(), maps.end(), [&](const SquareToSquareMap &map)
-                                             { return map.attacked == target_square; }));
-}
+        void add_targets(int, u64 targets) { count += static_cast<u64>(count_bits(targets)); }
+        MoveList &irregular_moves() { return special_moves; }
+        u64 total() const { return count + static_cast<u64>(special_moves.size()); }
+    };
 
-Square get_attacker(const std::vector<SquareToSquareMap> &maps, const Square &attacked_square)
-{
-    for (const SquareToSquareMap &map : maps)
+    // Legal moves handed to a sink: piece moves as target bitboards, pawn moves (with their promotions
+    // and en passant) and castles as moves on its irregular_moves() list
+    template <typename Sink>
+    u64 legal_moves(BoardRepresentation &board_representation, Sink &sink, bool only_captures)
     {
-        if (map.attacked == attacked_square)
+        // illegal cases are never generated
+        // 1. Castling through check
+        // 2. Leaving king in check.
+        // 3. Moving a pinned piece revealing the king
+        // 4. Moving king into check.
+
+        const u64 *bitboards = board_representation.piece_bitboards;
+        bool is_white = board_representation.white_to_move;
+        int offset = is_white ? WHITE_PAWN : BLACK_PAWN;
+        u64 friendly = is_white ? board_representation.white_pieces : board_representation.black_pieces;
+        u64 enemy = is_white ? board_representation.black_pieces : board_representation.white_pieces;
+        u64 target_mask = only_captures ? enemy : ~friendly;
+
+        int king_square = get_LSB_index(bitboards[offset + 5]);
+        u64 checkers = attackers_to(board_representation, king_square, board_representation.occupied) & enemy;
+        board_representation.is_in_check = (checkers != 0);
+
+        // King moves, looking through the king's own square so it cannot step back along a checking ray
+        u64 king_targets = KING_ATTACKS[king_square] & target_mask;
+        u64 safe_king_targets = 0ULL;
+        u64 occupied_without_king = board_representation.occupied ^ (1ULL << king_square);
+        while (king_targets)
         {
-            return map.attacker;
+            int to_square = pop_LSB(king_targets);
+            if (!(attackers_to(board_representation, to_square, occupied_without_king) & enemy))
+            {
+                safe_king_targets |= 1ULL << to_square;
+            }
         }
-    }
+        sink.add_targets(king_square, safe_king_targets);
 
-    throw std::runtime_error("Square not under attack.");
-}
-
-std::vector<Square> get_all_attackers(const std::vector<SquareToSquareMap> &maps, const Square &attacked_square)
-{
-    std::vector<Square> attackers;
-
-    for (const SquareToSquareMap &map : maps)
-    {
-        if (map.attacked == attacked_square)
+        // Double check requires a king move
+        if (count_bits(checkers) > 1)
         {
-            attackers.push_back(map.attacker);
+            return sink.total();
         }
-    }
-
-    return attackers;
-}
 
-u64 generate_legal_moves(BoardRepresentation &board_representation, std::vector<Move> &move_list, bool only_captures)
-{
-    // illegal cases
-    // 1. Castling through check
-    // 2. Leaving king in check.
-    // 3. Moving a pinned piece revealing the king
-    // 4. Moving king into check.
-
-    std::vector<Move> pseudo_legal_move_list;
-    std::vector<SquareToSquareMap> attacked_squares;
-    Square king_position;
-
-    generate_pseudo_legal_moves(board_representation, pseudo_legal_move_list, attacked_squares, king_position);
+        // In check every other move must capture the checking piece or block a sliding check
+        u64 check_mask = checkers ? (checkers | BETWEEN[king_square][get_LSB_index(checkers)]) : ~0ULL;
+        u64 pinned = get_pinned_pieces(board_representation, king_square);
 
-    // assert(king_position.exists());
-    // assert(attacked_squares.size() > 0);
-
-    for (const Move &move : pseudo_legal_move_list)
-    {
-        // check attacked squares to make sure castle is legal
-        if (move.is_castle)
+        // Pinned knights can never move
+        u64 knights = bitboards[offset + 1] & ~pinned;
+        while (knights)
         {
-            // check white kingside castle
-            if (board_representation.white_to_move && move.to_square.file == 6)
-            {
-                if (is_square_attacked(attacked_squares, Square(0, 4)) > 0 || // King's starting square
-                    is_square_attacked(attacked_squares, Square(0, 5)) > 0 || // Square the king moves through
-                    is_square_attacked(attacked_squares, Square(0, 6)) > 0)   // Square the king ends on
-                {
-                    continue; // Castle is not legal
-                }
-            }
-            // check white queenside castle
-            else if (board_representation.white_to_move && move.to_square.file == 2)
-            {
-                if (is_square_attacked(attacked_squares, Square(0, 4)) > 0 || // King's starting square
-                    is_square_attacked(attacked_squares, Square(0, 3)) > 0 || // Square the king moves through
-                    is_square_attacked(attacked_squares, Square(0, 2)) > 0)   // Square the king ends on
-                {
-                    continue; // Castle is not legal
-                }
-            }
-            // check black kingside castle
-            else if (!board_representation.white_to_move && move.to_square.file == 6)
-            {
-                if (is_square_attacked(attacked_squares, Square(7, 4)) > 0 || // King's starting square
-                    is_square_attacked(attacked_squares, Square(7, 5)) > 0 || // Square the king moves through
-                    is_square_attacked(attacked_squares, Square(7, 6)) > 0)   // Square the king ends on
-                {
-                    continue; // Castle is not legal
-                }
-            }
-            // check black queenside castle
-            else if (!board_representation.white_to_move && move.to_square.file == 2)
-            {
-                if (is_square_attacked(attacked_squares, Square(7, 4)) > 0 || // King's starting square
-                    is_square_attacked(attacked_squares, Square(7, 3)) > 0 || // Square the king moves through
-                    is_square_attacked(attacked_squares, Square(7, 2)) > 0)   // Square the king ends on
-                {
-                    continue; // Castle is not legal
-                }
-            }
+            int from_square = pop_LSB(knights);
+            sink.add_targets(from_square, KNIGHT_ATTACKS[from_square] & target_mask & check_mask);
         }
-        else // different checks for none castling moves
+
+        // Sliders, a pinned slider may only move along the line through its king
+        u64 sliders = bitboards[offset + 2] | bitboards[offset + 3] | bitboards[offset + 4];
+        while (sliders)
         {
-            // check king move is not moving onto attacked square
-            if (move.start_square == king_position)
+            int from_square = pop_LSB(sliders);
+            u64 from_bit = 1ULL << from_square;
+            u64 attacks = 0ULL;
+
+            if (from_bit & (bitboards[offset + 2] | bitboards[offset + 4]))
             {
-                if (is_square_attacked(attacked_squares, move.to_square) > 0)
-                {
-                    // move is not legal, look at the next move
-                    continue;
-                }
-
-                std::vector<Square> attacker_squares = get_all_attackers(attacked_squares, king_position);
-                bool king_moves_along_checked_line = false;
-
-                for (const Square &attacker_square : attacker_squares)
-                {
-                    char piece = to_lower(board_representation.board[attacker_square.rank][attacker_square.file]);
-
-                    if (piece == 'q' || piece == 'b' || piece == 'r')
-                    {
-                        if (move.start_square.is_between(attacker_square, move.to_square))
-                        {
-                            king_moves_along_checked_line = true;
-                            break;
-                        }
-                    }
-                }
-
-                if (king_moves_along_checked_line)
-                    continue;
+                attacks |= bishop_attacks(from_square, board_representation.occupied);
             }
-            // if king is in check and the move is not a king move (checked in above condition)
-            else if (is_square_attacked(attacked_squares, king_position) > 0)
+            if (from_bit & (bitboards[offset + 3] | bitboards[offset + 4]))
             {
-                // these moves must either block or capture the attacking piece or else they are illegal
-
-                // Double check requires a king move
-                if (count_square_attacks(attacked_squares, king_position) > 1)
-                {
-                    continue;
-                }
-
-                Square attacker_square = get_attacker(attacked_squares, king_position);
-                char attacker = to_lower(board_representation.board[attacker_square.rank][attacker_square.file]);
-
-                // if we are not capturing the checking piece we must block the checking piece
-                if (!(move.to_square == attacker_square) && !move.is_enpassant)
-                {
-                    // this check only applies to sliding attacker pieces
-                    // Therefor if the attacker is not a queen, rook, or bishop the move is not valid
-                    if (attacker != 'q' && attacker != 'b' && attacker != 'r')
-                    {
-                        continue;
-                    }
-
-                    // check if piece is moving between king and attacker
-                    if (!move.to_square.is_between(attacker_square, king_position))
-                    {
-                        // If not check the next move
-                        continue;
-                    }
-                }
-                else if (move.is_enpassant)
-                {
-                    // if we are in check and doing en passant we must be capturing the attacking square
-                    int rank_offset = board_representation.white_to_move ? 1 : -1;
-                    if (!(attacker_square.file == board_representation.en_passant_square.file &&
-                          attacker_square.rank + rank_offset == board_representation.en_passant_square.rank))
-                    {
-                        continue;
-                    }
-                }
+                attacks |= rook_attacks(from_square, board_representation.occupied);
             }
 
-            // Handle pinned pieces
-            // check if piece is attacked
-            if (is_square_attacked(attacked_squares, move.start_square))
+            u64 targets = attacks & target_mask & check_mask;
+            if (pinned & from_bit)
             {
-                bool respects_pin = true;
-                // If attacked check the pieces that are attacking it
-                // iterate through attacker squares for the attacked piece
-                for (const SquareToSquareMap &map : attacked_squares)
-                {
-                    if (map.attacked == move.start_square)
-                    {
-                        // if being attacked by sliding pieces we need to check if this piece is the only piece between attacker and king
-                        // if the piece is the only piece between attacker and king the only legal moves are between the attacker and king
-                        // or capturing the attacker
-                        char piece = to_lower(board_representation.board[map.attacker.rank][map.attacker.file]);
-                        if (piece == 'q' || piece == 'r' || piece == 'b')
-                        {
-                            // check if moving piece is only occupied square between attacker and king
-                            if (board_representation.is_only_between(map.attacker, king_position, move.start_square))
-                            {
-                                if (!move.to_square.is_between(map.attacker, king_position) && !(move.to_square == map.attacker))
-                                {
-                                    respects_pin = false;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
-
-                if (!respects_pin)
-                    continue;
-            }
-
-            // special pin handling for en passant
-            // special pin handling for en passant
-            if (move.is_enpassant)
-            {
-                bool en_passant_valid = true;
-                // check if en passant might open king rank
-                if (move.start_square.rank == king_position.rank)
-                {
-                    int direction = (king_position.file - move.start_square.file > 0) ? -1 : 1;
-                    int begin_iteration_file = (direction == 1) ? king_position.file + 1 : king_position.file - 1;
-
-                    // Generalized loop for both directions
-                    for (int i = begin_iteration_file; i >= 0 && i < 8; i += direction)
-                    {
-                        if (i == move.start_square.file || i == board_representation.en_passant_square.file)
-                        {
-                            continue;
-                        }
-
-                        if (board_representation.board[move.start_square.rank][i] == 'e')
-                        {
-                            continue;
-                        }
-
-                        // if we find a friendly piece, the en passant is valid
-                        if (!board_representation.is_opponent_piece(board_representation.board[move.start_square.rank][i]))
-                        {
-                            break;
-                        }
-
-                        char opponent_piece = to_lower(board_representation.board[move.start_square.rank][i]);
-                        if (opponent_piece == 'r' || opponent_piece == 'q')
-                        {
-                            en_passant_valid = false;
-                            break;
-                        }
-                        else
-                        {
-                            break;
-                        }
-                    }
-                }
-
-                if (!en_passant_valid)
-                {
-                    continue;
-                }
+                targets &= LINE[king_square][from_square];
             }
+            sink.add_targets(from_square, targets);
         }
 
-        if (board_representation.move_captures_king(move))
+        u64 pawns = bitboards[offset];
+        while (pawns)
         {
-            std::cout << "Move: " << move.to_UCI() << " captured the king.";
-            throw std::runtime_error("king was captured.");
-        }
-
-        // if the move has not been rejected to this point it is valid
-        // In only captures case check this condition
-        if (only_captures)
-        {
-            if (board_representation.board[move.to_square.rank][move.to_square.file] != 'e')
+            int from_square = pop_LSB(pawns);
+            u64 allowed_squares = check_mask;
+            if (pinned & (1ULL << from_square))
             {
-                move_list.push_back(move);
+                allowed_squares &= LINE[king_square][from_square];
             }
+            generate_pawn_moves(board_representation, sink.irregular_moves(), from_square, allowed_squares, only_captures);
         }
-        else
+
+        if (!checkers && !only_captures)
         {
-            move_list.push_back(move);
+            generate_castle(board_representation, sink.irregular_moves());
         }
-    }
 
-    if (is_square_attacked(attacked_squares, king_position))
-    {
-        board_representation.is_in_check = true;
-    }
-    else
-    {
-        board_representation.is_in_check = false;
+        return sink.total();
     }
+}
 
-    return static_cast<u64>(move_list.size());
-}
\ No newline at end of file
+u64 generate_legal_moves(BoardRepresentation &board_representation, MoveList &move_list, bool only_captures)
+{
+    MoveCollector collector(move_list);
+    return legal_moves(board_representation, collector, only_captures);
+}
+
+u64 count_legal_moves(BoardRepresentation &board_representation)
+{
+    MoveCounter counter;
+    return legal_moves(board_representation, counter, false);
+}
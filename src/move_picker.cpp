@@ -0,0 +1,183 @@
+#include "move_picker.h"
+#include "evaluation.h"
+
+#include <algorithm>
+
+// -----------------------
+// SearchHeuristics
+// -----------------------
+void SearchHeuristics::update_quiet_cutoff(bool white, int ply, int depth, const Move &move)
+{
+    if (!(killers[ply][0] == move))
+    {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    // Gravity keeps the score within MAX_HISTORY without periodic rescaling
+    int bonus = std::min(depth * depth, MAX_HISTORY);
+    int &entry = history[white][move.from()][move.to()];
+    entry += bonus - entry * bonus / MAX_HISTORY;
+
+    Move previous = previous_move(ply);
+    if (previous.is_instantiated())
+    {
+        countermoves[previous.from()][previous.to()] = move;
+    }
+}
+
+// -----------------------
+// MovePicker
+// -----------------------
+MovePicker::MovePicker(MoveList &moves_,
+                       const BoardRepresentation &board_representation_,
+                       const SearchHeuristics &heuristics_,
+                       const Move &tt_move_,
+                       int ply_)
+    : moves(moves_),
+      board_representation(board_representation_),
+      heuristics(heuristics_),
+      tt_move(tt_move_),
+      ply(ply_),
+      stage(Stage::TTMove),
+      scores(),
+      next(0),
+      capture_end(0),
+      bad_capture(0),
+      refutation_index(0)
+{
+}
+
+bool MovePicker::is_tactical(const Move &move) const
+{
+    return board_representation.board[move.to() / 8][move.to() % 8] != 'e' ||
+           move.is_enpassant() || move.is_promotion();
+}
+
+void MovePicker::swap_moves(std::size_t a, std::size_t b)
+{
+    std::swap(moves[a], moves[b]);
+    std::swap(scores[a], scores[b]);
+}
+
+bool MovePicker::pick_best(std::size_t begin, std::size_t end, Move &move)
+{
+    if (begin >= end)
+    {
+        return false;
+    }
+
+    std::size_t best = begin;
+    for (std::size_t i = begin + 1; i < end; ++i)
+    {
+        if (scores[i] > scores[best])
+        {
+            best = i;
+        }
+    }
+    swap_moves(begin, best);
+    move = moves[begin];
+    return true;
+}
+
+bool MovePicker::next_move(Move &move)
+{
+    switch (stage)
+    {
+    case Stage::TTMove:
+        stage = Stage::ScoreCaptures;
+        if (tt_move.is_instantiated())
+        {
+            auto found = std::find(moves.begin(), moves.end(), tt_move);
+            if (found != moves.end())
+            {
+                std::swap(*moves.begin(), *found);
+                next = 1;
+                move = tt_move;
+                return true;
+            }
+        }
+        [[fallthrough]];
+
+    case Stage::ScoreCaptures:
+    {
+        Move *split = std::partition(moves.begin() + next, moves.end(), [this](const Move &candidate)
+                                     { return is_tactical(candidate); });
+        capture_end = static_cast<std::size_t>(split - moves.begin());
+        for (std::size_t i = next; i < capture_end; ++i)
+        {
+            scores[i] = compute_move_score(moves[i], board_representation);
+        }
+        stage = Stage::GoodCaptures;
+    }
+        [[fallthrough]];
+
+    case Stage::GoodCaptures:
+        if (pick_best(next, capture_end, move) && scores[next] >= GOOD_CAPTURE_SCORE)
+        {
+            ++next;
+            return true;
+        }
+        // Whatever is left of the captures loses material; search it last
+        bad_capture = next;
+        next = capture_end;
+        stage = Stage::Refutations;
+        [[fallthrough]];
+
+    case Stage::Refutations:
+        while (refutation_index < 3)
+        {
+            int index = refutation_index++;
+            Move candidate = (index < 2) ? heuristics.killer(ply, index)
+                                         : heuristics.countermove(heuristics.previous_move(ply));
+            if (!candidate.is_instantiated() || candidate == tt_move ||
+                (index == 2 && heuristics.is_killer(ply, candidate)))
+            {
+                continue;
+            }
+
+            // Refutations are quiet moves, so only look among the quiets not handed out yet
+            auto found = std::find(moves.begin() + next, moves.end(), candidate);
+            if (found != moves.end())
+            {
+                std::swap(moves[next], *found);
+                move = moves[next++];
+                return true;
+            }
+        }
+        stage = Stage::ScoreQuiets;
+        [[fallthrough]];
+
+    case Stage::ScoreQuiets:
+        for (std::size_t i = next; i < moves.size(); ++i)
+        {
+            scores[i] = heuristics.history_score(board_representation.white_to_move, moves[i]);
+        }
+        stage = Stage::Quiets;
+        [[fallthrough]];
+
+    case Stage::Quiets:
+        if (pick_best(next, moves.size(), move))
+        {
+            ++next;
+            return true;
+        }
+        next = bad_capture;
+        stage = Stage::BadCaptures;
+        [[fallthrough]];
+
+    case Stage::BadCaptures:
+        if (pick_best(next, capture_end, move))
+        {
+            ++next;
+            return true;
+        }
+        stage = Stage::Done;
+        [[fallthrough]];
+
+    case Stage::Done:
+        return false;
+    }
+
+    return false;
+}
@@ -0,0 +1,25 @@
+// pawn_hash_table.cpp
+#include "pawn_hash_table.h"
+
+PawnHashTable::PawnHashTable()
+    : entries(std::make_unique<PawnHashEntry[]>(PAWN_HASH_ENTRIES))
+{
+}
+
+bool PawnHashTable::probe(std::uint64_t pawn_key, int &score) const
+{
+    const PawnHashEntry &entry = entries[pawn_key & (PAWN_HASH_ENTRIES - 1)];
+    if (entry.key != pawn_key)
+    {
+        return false;
+    }
+    score = entry.score;
+    return true;
+}
+
+void PawnHashTable::store(std::uint64_t pawn_key, int score)
+{
+    PawnHashEntry &entry = entries[pawn_key & (PAWN_HASH_ENTRIES - 1)];
+    entry.key = pawn_key;
+    entry.score = score;
+}
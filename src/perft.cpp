@@ -0,0 +1,219 @@
+// perft.cpp
+#include "perft.h"
+#include "move_generator.h"
+#include "move_list.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+PerftTable::PerftTable(std::size_t megabytes)
+    : entries(), mask(0)
+{
+    std::size_t count = std::bit_floor(std::max<std::size_t>(megabytes * 1024 * 1024 / sizeof(Entry), 1));
+    entries = std::make_unique<Entry[]>(count);
+    mask = count - 1;
+}
+
+std::uint64_t PerftTable::entry_key(std::uint64_t hash_key, int depth)
+{
+    return hash_key ^ (static_cast<std::uint64_t>(depth) * std::uint64_t{0x9E3779B97F4A7C15});
+}
+
+bool PerftTable::probe(std::uint64_t hash_key, int depth, std::uint64_t &nodes) const
+{
+    std::uint64_t key = entry_key(hash_key, depth);
+    const Entry &entry = entries[key & mask];
+    std::uint64_t stored = entry.nodes.load(std::memory_order_relaxed);
+    // An empty slot has no nodes, which no stored subtree of depth 2 or more can have
+    if ((entry.key.load(std::memory_order_relaxed) ^ stored) != key || stored == 0)
+    {
+        return false;
+    }
+    nodes = stored;
+    return true;
+}
+
+void PerftTable::store(std::uint64_t hash_key, int depth, std::uint64_t nodes)
+{
+    std::uint64_t key = entry_key(hash_key, depth);
+    Entry &entry = entries[key & mask];
+    entry.nodes.store(nodes, std::memory_order_relaxed);
+    entry.key.store(key ^ nodes, std::memory_order_relaxed);
+}
+
+std::uint64_t perft(BoardRepresentation &board, int depth, PerftTable *table, const SearchLimits *limits)
+{
+    if (depth <= 0)
+    {
+        return 1;
+    }
+    if (depth == 1)
+    {
+        return count_legal_moves(board);
+    }
+
+    // Leaf parents are too cheap to be worth polling
+    if (limits && depth >= 3 && limits->stopped())
+    {
+        return 0;
+    }
+
+    std::uint64_t nodes = 0;
+    if (table && table->probe(board.zobrist_hash(), depth, nodes))
+    {
+        return nodes;
+    }
+
+    MoveList move_list;
+    generate_legal_moves(board, move_list);
+    for (const Move &move : move_list)
+    {
+        board.make_move(move);
+        nodes += perft(board, depth - 1, table, limits);
+        board.undo_move(move);
+    }
+
+    if (table && nodes > 0 && !(limits && limits->stopped()))
+    {
+        table->store(board.zobrist_hash(), depth, nodes);
+    }
+    return nodes;
+}
+
+namespace
+{
+    // One subtree of a divide: a root move, and a reply to it once the tree is deep enough to split further
+    struct PerftTask
+    {
+        std::size_t root_index;
+        Move reply;
+    };
+
+    // Count the subtrees of tasks taken off next until none are left, writing each count to its
+    // task's slot and marking the task done unless limits was stopped meanwhile
+    void run_perft_tasks(BoardRepresentation board,
+                         const MoveList &root_moves,
+                         const std::vector<PerftTask> &tasks,
+                         int depth,
+                         PerftTable *table,
+                         const SearchLimits *limits,
+                         std::atomic<std::size_t> &next,
+                         std::vector<std::uint64_t> &task_nodes,
+                         std::vector<char> &task_done)
+    {
+        for (std::size_t i = next++; i < tasks.size(); i = next++)
+        {
+            const PerftTask &task = tasks[i];
+            const Move &root_move = root_moves[task.root_index];
+            board.make_move(root_move);
+            if (task.reply.is_instantiated())
+            {
+                board.make_move(task.reply);
+                task_nodes[i] = perft(board, depth - 2, table, limits);
+                board.undo_move(task.reply);
+            }
+            else
+            {
+                task_nodes[i] = perft(board, depth - 1, table, limits);
+            }
+            board.undo_move(root_move);
+
+            // A stop during the task may have cut its count short
+            task_done[i] = !(limits && limits->stopped());
+        }
+    }
+}
+
+std::uint64_t perft_divide(BoardRepresentation &board,
+                           int depth,
+                           std::ostream &out,
+                           PerftTable *table,
+                           int threads,
+                           const SearchLimits *limits)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // At depth 0 the position itself is the only leaf, so no root move gets a line
+    MoveList root_moves;
+    if (depth > 0)
+    {
+        generate_legal_moves(board, root_moves);
+    }
+
+    // Root moves alone are too few and too uneven to keep many workers busy, so split a ply deeper
+    std::vector<PerftTask> tasks;
+    for (std::size_t i = 0; i < root_moves.size(); ++i)
+    {
+        MoveList replies;
+        if (depth >= 3 && threads > 1)
+        {
+            board.make_move(root_moves[i]);
+            generate_legal_moves(board, replies);
+            board.undo_move(root_moves[i]);
+        }
+
+        if (replies.empty())
+        {
+            tasks.push_back(PerftTask{i, Move()});
+        }
+        for (const Move &reply : replies)
+        {
+            tasks.push_back(PerftTask{i, reply});
+        }
+    }
+
+    std::vector<std::uint64_t> task_nodes(tasks.size(), 0);
+    std::vector<char> task_done(tasks.size(), 0);
+    std::atomic<std::size_t> next(0);
+    std::vector<std::thread> workers;
+    std::size_t worker_count = std::min(static_cast<std::size_t>(std::max(threads, 1)), std::max<std::size_t>(tasks.size(), 1));
+    for (std::size_t i = 1; i < worker_count; ++i)
+    {
+        workers.emplace_back(run_perft_tasks,
+                             board,
+                             std::cref(root_moves),
+                             std::cref(tasks),
+                             depth,
+                             table,
+                             limits,
+                             std::ref(next),
+                             std::ref(task_nodes),
+                             std::ref(task_done));
+    }
+    run_perft_tasks(board, root_moves, tasks, depth, table, limits, next, task_nodes, task_done);
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    // Tasks were queued in root move order, so adding them up in order rebuilds the divide
+    std::vector<std::uint64_t> root_nodes(root_moves.size(), 0);
+    std::vector<char> root_done(root_moves.size(), 1);
+    for (std::size_t i = 0; i < tasks.size(); ++i)
+    {
+        root_nodes[tasks[i].root_index] += task_nodes[i];
+        root_done[tasks[i].root_index] &= task_done[i];
+    }
+
+    std::uint64_t total = (depth > 0) ? 0 : 1;
+    for (std::size_t i = 0; i < root_moves.size(); ++i)
+    {
+        if (!root_done[i])
+        {
+            continue;
+        }
+        total += root_nodes[i];
+        out << root_moves[i].to_UCI() << ": " << root_nodes[i] << '\n';
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::uint64_t milliseconds = static_cast<std::uint64_t>(elapsed.count());
+    out << '\n'
+        << "Nodes searched: " << total << '\n'
+        << "Time: " << milliseconds << " ms" << '\n'
+        << "NPS: " << total * 1000 / std::max<std::uint64_t>(milliseconds, 1) << std::endl;
+    return total;
+}
@@ -0,0 +1,194 @@
+#include "search_controller.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <sstream>
+
+SearchController::SearchController(std::ostream &out_)
+    : out(out_), output_mutex(), search_thread(), limits(), threads(1), report_result(true)
+{
+}
+
+SearchController::~SearchController()
+{
+    abort();
+}
+
+void SearchController::set_threads(int count)
+{
+    threads = std::clamp(count, 1, MAX_SEARCH_THREADS);
+}
+
+void SearchController::send(const std::string &line)
+{
+    {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        out << line << std::endl;
+    }
+    ThreadSafeLogger::getInstance("logs/app_log.txt").write("Output", line);
+}
+
+void SearchController::launch(std::function<void()> task, bool hold_result)
+{
+    abort(); // only one search at a time
+
+    limits.reset();
+    report_result = true;
+    if (hold_result)
+    {
+        // Before the thread starts, so a stop or ponderhit arriving right away still releases it
+        limits.hold_result();
+    }
+
+    search_thread = std::thread([task]()
+                                {
+        try
+        {
+            task();
+        }
+        catch (const std::exception &e)
+        {
+            // Same outcome as an error on the UCI loop: log it and exit with a failure code
+            ThreadSafeLogger &logger = ThreadSafeLogger::getInstance("logs/app_log.txt");
+            logger.write("ERROR", e.what());
+            logger.flush();
+            std::quick_exit(1);
+        } });
+}
+
+void SearchController::start(std::function<Evaluation()> run, bool hold_result)
+{
+    launch([this, run]()
+           {
+        Evaluation position_evaluation = run();
+        limits.wait_for_release();
+
+        if (!report_result.load())
+        {
+            return;
+        }
+
+        if (!position_evaluation.best_move.is_instantiated())
+        {
+            throw std::runtime_error("Best move not instantiated");
+        }
+
+        std::string line = "bestmove " + position_evaluation.best_move.to_UCI();
+        if (position_evaluation.ponder_move.is_instantiated())
+        {
+            line += " ponder " + position_evaluation.ponder_move.to_UCI();
+        }
+        send(line); },
+           hold_result);
+}
+
+void SearchController::go(const BoardRepresentation &board_representation,
+                          TranspositionTable &transposition_table,
+                          int wtime, int btime, int winc, int binc, int forced_time)
+{
+    start([this, board = BoardRepresentation(board_representation), &transposition_table, wtime, btime, winc, binc, forced_time, thread_count = threads]() mutable
+          { return find_best_move(board, transposition_table, true,
+                                  wtime, btime, winc, binc,
+                                  forced_time, &limits, thread_count); });
+}
+
+void SearchController::go_depth(const BoardRepresentation &board_representation,
+                                TranspositionTable &transposition_table,
+                                int depth)
+{
+    // Set inside the search thread, after start() has reset the limits
+    start([this, board = BoardRepresentation(board_representation), &transposition_table, thread_count = threads,
+           max_depth = std::clamp(depth, 1, MAX_SEARCH_DEPTH)]() mutable
+          {
+              limits.max_depth = max_depth;
+              return run_iterative_deepening(board, transposition_table, true, limits, thread_count); });
+}
+
+void SearchController::go_infinite(const BoardRepresentation &board_representation,
+                                   TranspositionTable &transposition_table)
+{
+    start([this, board = BoardRepresentation(board_representation), &transposition_table, thread_count = threads]() mutable
+          { return run_iterative_deepening(board, transposition_table, true, limits, thread_count); },
+          true);
+}
+
+void SearchController::go_ponder(const BoardRepresentation &board_representation,
+                                 TranspositionTable &transposition_table,
+                                 int wtime, int btime, int winc, int binc, int forced_time)
+{
+    BoardRepresentation board = board_representation;
+    std::chrono::milliseconds budget = allocate_search_time(board, wtime, btime, winc, binc, forced_time);
+
+    // The budget only starts counting down once ponderhit arrives
+    start([this, board, &transposition_table, thread_count = threads]() mutable
+          { return run_iterative_deepening(board, transposition_table, true, limits, thread_count); },
+          true);
+    limits.set_time_budget(budget);
+}
+
+void SearchController::go_perft(const BoardRepresentation &board_representation, int depth)
+{
+    launch([this, board = BoardRepresentation(board_representation), depth, thread_count = threads]() mutable
+           {
+        PerftTable perft_table(PERFT_HASH_MB);
+        std::ostringstream divide;
+        perft_divide(board, depth, divide, &perft_table, thread_count, &limits);
+
+        if (!report_result.load())
+        {
+            return;
+        }
+
+        std::string line;
+        std::istringstream divide_lines(divide.str());
+        while (std::getline(divide_lines, line))
+        {
+            send(line);
+        } });
+}
+
+void SearchController::go_bench(int depth)
+{
+    launch([this, depth]()
+           {
+        std::ostringstream report;
+        run_bench(report, depth, &limits);
+
+        if (!report_result.load())
+        {
+            return;
+        }
+
+        std::string line;
+        std::istringstream report_lines(report.str());
+        while (std::getline(report_lines, line))
+        {
+            send(line);
+        } });
+}
+
+void SearchController::on_ponder_hit()
+{
+    limits.start_clock();
+    limits.release_result();
+
+    std::ostringstream oss;
+    oss << "Ponderhit, now searching up to " << limits.get_time_budget().count() << " ms more";
+    ThreadSafeLogger::getInstance("logs/app_log.txt").write("Debug", oss.str());
+}
+
+void SearchController::stop()
+{
+    if (search_thread.joinable())
+    {
+        limits.stop();
+        search_thread.join();
+    }
+}
+
+void SearchController::abort()
+{
+    report_result = false;
+    stop();
+}
@@ -0,0 +1,24 @@
+#include "bench.h"
+#include "attack_tables.h"
+#include "zobrist_values.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+TEST(BenchTest, NodeCountIsDeterministic)
+{
+    init_zobrist_keys();
+    init_attack_tables();
+
+    std::ostringstream first, second;
+    std::uint64_t first_nodes = run_bench(first, 4);
+    std::uint64_t second_nodes = run_bench(second, 4);
+
+    EXPECT_GT(first_nodes, 0ULL);
+    EXPECT_EQ(first_nodes, second_nodes);
+
+    // Everything up to the timing lines is the same
+    std::string first_report = first.str(), second_report = second.str();
+    EXPECT_EQ(first_report.substr(0, first_report.find("Time:")), second_report.substr(0, second_report.find("Time:")));
+    EXPECT_NE(first_report.find("Nodes searched: " + std::to_string(first_nodes) + "\n"), std::string::npos);
+}
@@ -24,7 +24,12 @@ void test_move(BoardRepresentation &board, const std::string &input_fen,
                const std::string &move, const std::string &expected_fen)
 {
     // Load the initial FEN position
+    init_zobrist_keys();
     board.input_fen_position(input_fen);
+    std::uint64_t input_hash = board.zobrist_hash();
+    int input_midgame_score = board.midgame_score;
+    int input_endgame_score = board.endgame_score;
+    std::uint64_t input_pawn_key = board.pawn_key;
 
     // Step 1: Assert input FEN is consistent with board's output FEN
     EXPECT_EQ(input_fen, board.output_fen_position());
@@ -32,10 +37,23 @@ void test_move(BoardRepresentation &board, const std::string &input_fen,
     // Step 2: Make the move and check FEN after the move
     Move move_struct = board.make_move(move);
     EXPECT_EQ(expected_fen, board.output_fen_position());
+    EXPECT_EQ(board.compute_zobrist_hash(), board.zobrist_hash());
+
+    // Incremental evaluation terms must match a board set up from scratch
+    BoardRepresentation expected_board(expected_fen);
+    EXPECT_EQ(expected_board.material[0], board.material[0]);
+    EXPECT_EQ(expected_board.material[1], board.material[1]);
+    EXPECT_EQ(expected_board.midgame_score, board.midgame_score);
+    EXPECT_EQ(expected_board.endgame_score, board.endgame_score);
+    EXPECT_EQ(expected_board.pawn_key, board.pawn_key);
 
     // Step 3: Undo the move and check FEN is reverted to the input FEN
     board.undo_move(move_struct);
     EXPECT_EQ(input_fen, board.output_fen_position());
+    EXPECT_EQ(input_hash, board.zobrist_hash());
+    EXPECT_EQ(input_midgame_score, board.midgame_score);
+    EXPECT_EQ(input_endgame_score, board.endgame_score);
+    EXPECT_EQ(input_pawn_key, board.pawn_key);
 }
 
 TEST(BoardRepresentationTest, PromotionUndo)
@@ -172,3 +190,84 @@ TEST(BoardRepresentationTest, IsOnlyBetween)
     Square opp_bishop = Square(5, 2);
     ASSERT_TRUE(board.is_only_between(king, opp_bishop, between_square));
 }
+
+TEST(BoardRepresentationTest, NullMoveRoundTrip)
+{
+    init_zobrist_keys();
+    BoardRepresentation board = BoardRepresentation("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+    std::uint64_t hash = board.zobrist_hash();
+
+    board.make_null_move();
+    ASSERT_EQ("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 1 2", board.output_fen_position());
+    ASSERT_EQ(board.compute_zobrist_hash(), board.zobrist_hash());
+
+    board.undo_null_move();
+    ASSERT_EQ("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", board.output_fen_position());
+    ASSERT_EQ(hash, board.zobrist_hash());
+}
+
+TEST(BoardRepresentationTest, StartingPositionScoresAreBalanced)
+{
+    BoardRepresentation board;
+
+    EXPECT_EQ(3900, board.material[0]);
+    EXPECT_EQ(3900, board.material[1]);
+    EXPECT_EQ(0, board.midgame_score);
+    EXPECT_EQ(0, board.endgame_score);
+}
+
+TEST(BoardRepresentationTest, RepetitionDetection)
+{
+    init_zobrist_keys();
+    BoardRepresentation board = BoardRepresentation(START_POS, {"g1f3", "g8f6", "f3g1", "f6g8"});
+
+    // Seen once before in the game: only a draw if the earlier occurrence is inside the search tree
+    EXPECT_FALSE(board.is_repetition(0));
+    EXPECT_TRUE(board.is_repetition(5));
+
+    const Move knight_out = board.make_move("g1f3");
+    const Move knight_back = board.make_move("g8f6");
+    EXPECT_FALSE(board.is_repetition(0));
+    board.undo_move(knight_back);
+    board.undo_move(knight_out);
+
+    // A third occurrence is a draw anywhere
+    board = BoardRepresentation(START_POS, {"g1f3", "g8f6", "f3g1", "f6g8", "g1f3", "g8f6", "f3g1", "f6g8"});
+    EXPECT_TRUE(board.is_repetition(0));
+
+    // Passing in between does not count as repeating
+    board = BoardRepresentation();
+    board.make_move("g1f3");
+    board.make_null_move();
+    board.make_move("f3g1");
+    board.make_null_move();
+    EXPECT_EQ(BoardRepresentation().zobrist_hash(), board.zobrist_hash());
+    EXPECT_FALSE(board.is_repetition(4));
+}
+
+TEST(BoardRepresentationTest, GameLongerThanMoveHistory)
+{
+    init_zobrist_keys();
+
+    // Knights shuffling for more plies than the history holds, with a pawn move halfway
+    std::vector<std::string> moves;
+    for (std::size_t i = 0; i < MAX_GAME_PLY / 4; ++i)
+    {
+        moves.insert(moves.end(), {"g1f3", "g8f6", "f3g1", "f6g8"});
+    }
+    moves.insert(moves.end(), {"e2e4", "e7e5"});
+    for (std::size_t i = 0; i < MAX_GAME_PLY / 4; ++i)
+    {
+        moves.insert(moves.end(), {"g1f3", "g8f6", "f3g1", "f6g8"});
+    }
+
+    BoardRepresentation board = BoardRepresentation(START_POS, moves);
+    EXPECT_EQ(BoardRepresentation("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 1").zobrist_hash(),
+              board.zobrist_hash());
+    EXPECT_TRUE(board.is_repetition(0));
+
+    // The search still has its room on top of the game, and sees the shuffles kept from it
+    const Move knight_out = board.make_move("g1f3");
+    EXPECT_TRUE(board.is_repetition(1));
+    board.undo_move(knight_out);
+}
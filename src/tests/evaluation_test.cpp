@@ -4,6 +4,7 @@
 TEST(EvaluationTest, TestMateIn1)
 {
     init_zobrist_keys();
+    init_attack_tables();
     BoardRepresentation board_representation = BoardRepresentation("8/8/8/8/kr5Q/8/8/1R5K w - - 0 1");
     TranspositionTable transposition_table;
     Evaluation eval = find_best_move(board_representation, transposition_table);
@@ -15,6 +16,7 @@ TEST(EvaluationTest, TestMateIn1)
 TEST(EvaluationTest, TestMateIn2)
 {
     init_zobrist_keys();
+    init_attack_tables();
     BoardRepresentation board_representation = BoardRepresentation("2R5/2R5/8/8/8/7K/pn6/k1r3r1 w - - 0 1");
     TranspositionTable transpo;
     Evaluation eval = find_best_move(board_representation, transpo);
@@ -23,9 +25,22 @@ TEST(EvaluationTest, TestMateIn2)
     EXPECT_EQ(MATE_SCORE - 3, eval.evaluation);
 }
 
+TEST(EvaluationTest, TestMateIn3)
+{
+    // Long enough for null-move and late-move reductions to cut depth inside the mating line
+    init_zobrist_keys();
+    init_attack_tables();
+    BoardRepresentation board_representation = BoardRepresentation("r5rk/5p1p/5R2/4B3/8/8/7P/7K w - - 0 1");
+    TranspositionTable transposition_table;
+    Evaluation eval = find_best_move(board_representation, transposition_table);
+
+    EXPECT_EQ(MATE_SCORE - 5, eval.evaluation);
+}
+
 TEST(EvaluationTest, TestAvoidStalemate)
 {
     init_zobrist_keys();
+    init_attack_tables();
     BoardRepresentation board_representation = BoardRepresentation("6Q1/8/7k/8/4p3/PP2P3/4KPP1/8 w - - 0 1");
     TranspositionTable transpo;
     Evaluation eval = find_best_move(board_representation, transpo);
@@ -34,34 +49,28 @@ TEST(EvaluationTest, TestAvoidStalemate)
 
 TEST(EvaluationTest, KingSafetyTest1)
 {
+    init_attack_tables();
     BoardRepresentation board_representation = BoardRepresentation("1k1r1bnr/ppp5/2nq4/5b2/5B2/P1NQ4/P1P5/1K1R1BNR w - - 0 1");
-    Square king_pos = Square(0, 1);
-    Square opp_pos = Square(7, 1);
-    std::vector<Square> friendly_pawns = {Square(2, 0), Square(1, 0), Square(1, 2)};
-    std::vector<Square> opp_pawns = {Square(6, 0), Square(6, 1), Square(6, 2)};
 
-    int king_safety_score = evaluate_king_safety(board_representation, 0.8, friendly_pawns, opp_pawns, king_pos, opp_pos);
+    int king_safety_score = evaluate_king_safety(board_representation, MIDGAME_MATERIAL);
     int expected = (CLOSE_PAWN_BONUS * 2) - OPEN_KING_FILE_PENALTY - (CLOSE_PAWN_BONUS * 3);
     EXPECT_EQ(king_safety_score, expected);
 }
 
 TEST(EvaluationTest, KingSafetyTest2)
 {
+    init_attack_tables();
     BoardRepresentation board_representation = BoardRepresentation("1k1r1bnr/ppp5/2nq4/5b2/5B2/P1NQ4/P1P5/1K1R1BNR b - - 0 1");
-    Square king_pos = Square(7, 1);
-    Square opp_pos = Square(0, 1);
-    std::vector<Square> friendly_pawns = {Square(6, 0), Square(6, 1), Square(6, 2)};
-    std::vector<Square> opp_pawns = {Square(2, 0), Square(1, 0), Square(1, 2)};
 
-    int king_safety_score = evaluate_king_safety(board_representation, 0.8, friendly_pawns, opp_pawns, king_pos, opp_pos);
+    int king_safety_score = evaluate_king_safety(board_representation, MIDGAME_MATERIAL);
     int expected = -(CLOSE_PAWN_BONUS * 2) + OPEN_KING_FILE_PENALTY + (CLOSE_PAWN_BONUS * 3);
     EXPECT_EQ(king_safety_score, expected);
 }
 
 TEST(EvaluationTest, DoubledPawnsTest1)
 {
-    std::vector<Square> friendly_pawns = {Square(6, 0), Square(6, 1), Square(6, 2)};
-    std::vector<Square> opp_pawns = {Square(2, 0), Square(1, 0), Square(1, 2)};
+    u64 friendly_pawns = (1ULL << 48) | (1ULL << 49) | (1ULL << 50); // a7, b7, c7
+    u64 opp_pawns = (1ULL << 16) | (1ULL << 8) | (1ULL << 10);      // a3, a2, c2
 
     int doubled_pawn_score = evaluate_doubled_pawns(friendly_pawns, opp_pawns);
     int expected = DOUBLED_PAWN_PENALTY;
@@ -70,17 +79,30 @@ TEST(EvaluationTest, DoubledPawnsTest1)
 
 TEST(EvaluationTest, DoubledPawnsTest2)
 {
-    std::vector<Square> friendly_pawns = {Square(2, 0), Square(1, 0), Square(1, 2)};
-    std::vector<Square> opp_pawns = {Square(6, 0), Square(6, 1), Square(6, 2)};
+    u64 friendly_pawns = (1ULL << 16) | (1ULL << 8) | (1ULL << 10); // a3, a2, c2
+    u64 opp_pawns = (1ULL << 48) | (1ULL << 49) | (1ULL << 50);      // a7, b7, c7
 
     int doubled_pawn_score = evaluate_doubled_pawns(friendly_pawns, opp_pawns);
     int expected = -DOUBLED_PAWN_PENALTY;
     EXPECT_EQ(doubled_pawn_score, expected);
 }
 
+TEST(EvaluationTest, PawnStructureTest)
+{
+    // White: isolated a-pawn and isolated doubled c-pawns, all held up by b7
+    // Black: isolated b-pawn, connected passed pawns on e5 and f5
+    BoardRepresentation board_representation = BoardRepresentation("4k3/1p6/8/P3pp2/8/2P5/2P5/4K3 w - - 0 1");
+
+    int white_score = -3 * ISOLATED_PAWN_PENALTY - DOUBLED_PAWN_PENALTY;
+    int black_score = -ISOLATED_PAWN_PENALTY + 2 * PASSED_PAWN_BONUS[3];
+    EXPECT_EQ(white_score - black_score, evaluate_pawn_structure(board_representation.piece_bitboards[WHITE_PAWN],
+                                                                 board_representation.piece_bitboards[BLACK_PAWN]));
+}
+
 TEST(EvaluationTest, ThreefoldTest)
 {
     init_zobrist_keys();
+    init_attack_tables();
     TranspositionTable transposition_table;
     std::vector<std::string> moves = {"h1g1", "a5a6", "g1h1", "a6a5", "h1g1", "a5a6", "g1h1"};
     BoardRepresentation board_representation = BoardRepresentation("8/8/8/k7/8/8/7N/7K w - - 0 1", moves);
@@ -90,3 +112,83 @@ TEST(EvaluationTest, ThreefoldTest)
     EXPECT_EQ("a6a5", eval.best_move.to_UCI());
     EXPECT_EQ(0, eval.evaluation);
 }
+
+TEST(EvaluationTest, TestMateIn2WithHelperThreads)
+{
+    init_zobrist_keys();
+    init_attack_tables();
+    BoardRepresentation board_representation = BoardRepresentation("2R5/2R5/8/8/8/7K/pn6/k1r3r1 w - - 0 1");
+    TranspositionTable transposition_table;
+    Evaluation eval = find_best_move(board_representation, transposition_table, false,
+                                     30000, 30000, 0, 0, 500, nullptr, 4);
+
+    EXPECT_EQ("c7c1", eval.best_move.to_UCI());
+    EXPECT_EQ(MATE_SCORE - 3, eval.evaluation);
+}
+
+TEST(EvaluationTest, StaticExchangeEvaluation)
+{
+    init_attack_tables();
+
+    // Rook takes an undefended pawn
+    BoardRepresentation board_representation = BoardRepresentation("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1");
+    EXPECT_EQ(100, static_exchange_evaluation(board_representation, Move(Square(0, 4), Square(4, 4))));
+
+    // Knight takes a pawn defended by a pawn, with a rook and queen x-raying behind
+    board_representation = BoardRepresentation("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1");
+    EXPECT_EQ(-200, static_exchange_evaluation(board_representation, Move(Square(2, 3), Square(4, 4))));
+
+    // Pawn takes a knight defended by a pawn
+    board_representation = BoardRepresentation("4k3/8/2p5/3n4/4P3/8/8/4K3 w - - 0 1");
+    EXPECT_EQ(200, static_exchange_evaluation(board_representation, Move(Square(3, 4), Square(4, 3))));
+}
+
+TEST(EvaluationTest, EnPassantScoresAsCapture)
+{
+    init_attack_tables();
+
+    // Undefended pawn taken en passant is a winning capture, not a quiet move
+    BoardRepresentation board_representation = BoardRepresentation("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+    Move en_passant(Square(4, 4), Square(5, 3), true);
+    EXPECT_EQ(100, static_exchange_evaluation(board_representation, en_passant));
+    EXPECT_GE(compute_move_score(en_passant, board_representation), GOOD_CAPTURE_SCORE);
+}
+
+TEST(EvaluationTest, QuiescenceStoresItsResult)
+{
+    init_zobrist_keys();
+    init_attack_tables();
+    BoardRepresentation board_representation = BoardRepresentation("4k3/8/2p5/3n4/4P3/8/8/4K3 w - - 0 1");
+    TranspositionTable transposition_table;
+    SearchLimits limits;
+
+    int score = search_captures(board_representation, transposition_table, limits, -MATE_SCORE, MATE_SCORE);
+
+    TranspositionRow row;
+    ASSERT_TRUE(transposition_table.get(board_representation.zobrist_hash(), row));
+    EXPECT_EQ(QUIESCENCE_DEPTH, row.depth);
+    EXPECT_EQ(EntryType::PV, row.entry_type);
+    EXPECT_EQ("e4d5", row.best_move.to_UCI());
+    EXPECT_EQ(score, row.eval);
+    EXPECT_EQ(2u, limits.nodes_searched()); // e4d5 and the recapture c6d5
+
+    // A second probe is answered from the table
+    EXPECT_EQ(score, search_captures(board_representation, transposition_table, limits, -MATE_SCORE, MATE_SCORE));
+}
+
+TEST(EvaluationTest, PieceSquareScoresMirrorByColour)
+{
+    for (int type = 0; type < 6; ++type)
+    {
+        for (int square = 0; square < 64; ++square)
+        {
+            // Flipping the rank turns a white piece's square into the matching black one
+            int mirrored = (7 - square / 8) * 8 + square % 8;
+            EXPECT_EQ(PIECE_SQUARE_SCORES.midgame[type][square], -PIECE_SQUARE_SCORES.midgame[type + 6][mirrored]);
+            EXPECT_EQ(PIECE_SQUARE_SCORES.endgame[type][square], -PIECE_SQUARE_SCORES.endgame[type + 6][mirrored]);
+        }
+    }
+
+    // White pawn on e4 from the pawn table row for the fourth rank
+    EXPECT_EQ(100 + pawn_piece_square_table[4][4], PIECE_SQUARE_SCORES.midgame[WHITE_PAWN][3 * 8 + 4]);
+}
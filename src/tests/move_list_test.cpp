@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "move_generator.h"
+#include "evaluation.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+// Count every heap allocation made by this test binary
+std::atomic<unsigned long> allocation_count(0);
+
+void *operator new(std::size_t size)
+{
+    allocation_count++;
+    void *pointer = std::malloc(size == 0 ? 1 : size);
+    if (!pointer)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+// Generate, make and undo every move down to the given depth
+unsigned long walk_tree(int depth, BoardRepresentation &board)
+{
+    MoveList move_list;
+    unsigned long nodes = generate_legal_moves(board, move_list);
+    if (depth == 1)
+    {
+        return nodes;
+    }
+
+    nodes = 0;
+    for (const Move &move : move_list)
+    {
+        board.make_move(move);
+        nodes += walk_tree(depth - 1, board);
+        board.undo_move(move);
+    }
+    return nodes;
+}
+
+TEST(MoveListTest, PushAndIndex)
+{
+    MoveList move_list;
+    EXPECT_TRUE(move_list.empty());
+
+    move_list.push_back(Move(Square(1, 4), Square(3, 4)));
+    move_list.push_back(Move(Square(6, 4), Square(4, 4)));
+    EXPECT_EQ(move_list.size(), 2u);
+    EXPECT_FALSE(move_list.empty());
+    EXPECT_EQ(move_list[1].to_UCI(), "e7e5");
+
+    move_list.clear();
+    EXPECT_TRUE(move_list.empty());
+}
+
+TEST(MoveListTest, WorksWithAlgorithms)
+{
+    MoveList move_list;
+    move_list.push_back(Move(Square(1, 4), Square(3, 4)));
+    move_list.push_back(Move(Square(0, 6), Square(2, 5)));
+    move_list.push_back(Move(Square(1, 3), Square(3, 3)));
+
+    Move *found = std::find(move_list.begin(), move_list.end(), Move(Square(0, 6), Square(2, 5)));
+    ASSERT_NE(found, move_list.end());
+    std::rotate(move_list.begin(), found, found + 1);
+    EXPECT_EQ(move_list[0].to_UCI(), "g1f3");
+    EXPECT_EQ(move_list[1].to_UCI(), "e2e4");
+}
+
+TEST(MoveListTest, NoAllocationsWhileWalkingTree)
+{
+    init_attack_tables();
+    BoardRepresentation board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    // Warm up once so containers owned by the board have reached their steady state size
+    walk_tree(3, board);
+
+    unsigned long allocations_before = allocation_count;
+    EXPECT_EQ(walk_tree(3, board), 97862u);
+    EXPECT_EQ(allocation_count - allocations_before, 0u);
+}
+
+TEST(MoveListTest, NoAllocationsWhileSearching)
+{
+    init_zobrist_keys();
+    init_attack_tables();
+    BoardRepresentation board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    // Setup that a search is handed rather than doing itself
+    TranspositionTable transposition_table;
+    SearchHeuristics heuristics;
+    SearchLimits limits;
+    MoveList top_depth_moves;
+    generate_legal_moves(board, top_depth_moves);
+    bool stop_flag = false;
+    const int infinity = std::numeric_limits<int>::max();
+
+    // The first evaluation allocates this thread's pawn hash table
+    search(board, transposition_table, top_depth_moves, 1, -infinity, infinity, 1, limits, heuristics, 0, stop_flag);
+
+    // Move ordering, the TT, quiescence, pruning and repetition checks all run at this depth
+    unsigned long allocations_before = allocation_count;
+    search(board, transposition_table, top_depth_moves, 4, -infinity, infinity, 4, limits, heuristics, 0, stop_flag);
+    EXPECT_GT(limits.nodes_searched(), 1000u);
+    EXPECT_EQ(allocation_count - allocations_before, 0u);
+}
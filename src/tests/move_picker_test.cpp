@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "move_picker.h"
+#include "move_generator.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    std::vector<std::string> pick_all(MovePicker &picker)
+    {
+        std::vector<std::string> picked;
+        Move move;
+        while (picker.next_move(move))
+        {
+            picked.push_back(move.to_UCI());
+        }
+        return picked;
+    }
+}
+
+TEST(MovePickerTest, HandsOutEveryMoveOnce)
+{
+    init_attack_tables();
+    BoardRepresentation board_representation("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    MoveList move_list;
+    generate_legal_moves(board_representation, move_list);
+    std::size_t move_count = move_list.size();
+
+    SearchHeuristics heuristics;
+    MovePicker picker(move_list, board_representation, heuristics, Move(), 0);
+    std::vector<std::string> picked = pick_all(picker);
+
+    ASSERT_EQ(move_count, picked.size());
+    std::sort(picked.begin(), picked.end());
+    EXPECT_TRUE(std::adjacent_find(picked.begin(), picked.end()) == picked.end());
+}
+
+TEST(MovePickerTest, StagesComeInOrder)
+{
+    init_attack_tables();
+    // White can win the queen on d5 with a pawn or lose the queen for the rook-defended pawn on a7
+    BoardRepresentation board_representation("r3k3/p7/8/3q4/4P3/8/8/Q3K2R w K - 0 1");
+    MoveList move_list;
+    generate_legal_moves(board_representation, move_list);
+
+    SearchHeuristics heuristics;
+    Move killer = Move(Square(0, 7), Square(3, 7)); // h1h4
+    heuristics.update_quiet_cutoff(true, 0, 4, killer);
+
+    Move tt_move = Move(Square(0, 4), Square(0, 5)); // e1f1
+    MovePicker picker(move_list, board_representation, heuristics, tt_move, 0);
+    std::vector<std::string> picked = pick_all(picker);
+
+    ASSERT_GE(picked.size(), 4u);
+    EXPECT_EQ("e1f1", picked[0]);
+    EXPECT_EQ("e4d5", picked[1]);
+    EXPECT_EQ("h1h4", picked[2]);
+    EXPECT_EQ("a1a7", picked.back());
+}
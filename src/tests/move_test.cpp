@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "move.h"
+
+TEST(MoveTest, FitsInTwoBytes)
+{
+    EXPECT_EQ(sizeof(Move), 2u);
+}
+
+TEST(MoveTest, UnpacksSquares)
+{
+    Move move = Move(Square(1, 4), Square(3, 4));
+    EXPECT_EQ(move.from(), 12);
+    EXPECT_EQ(move.to(), 28);
+    EXPECT_TRUE(move.start_square() == Square(1, 4));
+    EXPECT_TRUE(move.to_square() == Square(3, 4));
+    EXPECT_EQ(move.to_UCI(), "e2e4");
+}
+
+TEST(MoveTest, PromotionPieces)
+{
+    for (char piece : {'q', 'r', 'b', 'n'})
+    {
+        Move move = Move(52, 60, PROMOTION, piece);
+        EXPECT_TRUE(move.is_promotion());
+        EXPECT_EQ(move.promotion_piece(), piece);
+        EXPECT_EQ(move.to_UCI(), std::string("e7e8") + piece);
+    }
+}
+
+TEST(MoveTest, SpecialMoveFlags)
+{
+    Move castle = Move(Square(0, 4), Square(0, 6), false, true);
+    EXPECT_TRUE(castle.is_castle());
+    EXPECT_FALSE(castle.is_enpassant());
+    EXPECT_EQ(castle.promotion_piece(), 'x');
+
+    Move en_passant = Move(Square(4, 4), Square(5, 3), true, false);
+    EXPECT_TRUE(en_passant.is_enpassant());
+    EXPECT_FALSE(en_passant.is_castle());
+}
+
+TEST(MoveTest, EmptyMove)
+{
+    Move move;
+    EXPECT_FALSE(move.is_instantiated());
+    EXPECT_THROW(move.to_UCI(), std::runtime_error);
+}
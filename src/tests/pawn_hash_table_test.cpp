@@ -0,0 +1,21 @@
+#include "pawn_hash_table.h"
+#include <gtest/gtest.h>
+
+TEST(PawnHashTableTest, StoresAndReplacesByKey)
+{
+    PawnHashTable pawn_hash_table;
+    int score = 0;
+
+    EXPECT_FALSE(pawn_hash_table.probe(0x123456789ABCDEFULL, score));
+
+    pawn_hash_table.store(0x123456789ABCDEFULL, -35);
+    ASSERT_TRUE(pawn_hash_table.probe(0x123456789ABCDEFULL, score));
+    EXPECT_EQ(-35, score);
+
+    // A key sharing the slot pushes the first one out
+    std::uint64_t colliding_key = 0x123456789ABCDEFULL + PAWN_HASH_ENTRIES;
+    pawn_hash_table.store(colliding_key, 20);
+    EXPECT_FALSE(pawn_hash_table.probe(0x123456789ABCDEFULL, score));
+    ASSERT_TRUE(pawn_hash_table.probe(colliding_key, score));
+    EXPECT_EQ(20, score);
+}
@@ -1,87 +1,33 @@
 #include <gtest/gtest.h>
 #include "move_generator.h"
-#include <vector>
-#include <atomic>
-#include <chrono>
-#include <iostream>
-#include <cassert>
+#include "perft.h"
+#include "zobrist_values.h"
+#include <sstream>
+#include <string>
 
 typedef unsigned long long u64;
-std::atomic<u64> nodes_processed(0);
-std::chrono::time_point<std::chrono::steady_clock> last_update_time, start_time;
-int print_depth = 1;
-bool print_divide = true;
-
-// Courtesy of Chessprogrammingwiki
-u64 perf_t(int depth, BoardRepresentation &board, u64 expected_nodes)
-{
-    std::vector<Move> move_list;
-    u64 nodes = 0;
-
-    if (depth == 1)
-    {
-        u64 generated_count = generate_legal_moves(board, move_list);
-        if (print_divide && print_depth == 1)
-        {
-            for (const Move &move : move_list)
-            {
-                // Convert move to UCI notation (e.g., "e2e4")
-                std::string move_str = move.to_UCI(); // Implement this method
-
-                // Output the move and its node count
-                std::cout << move_str << ": " << 1 << std::endl;
-            }
-        }
-
-        // nodes_processed += generated_count;
-        return generated_count;
-    }
-
-    generate_legal_moves(board, move_list);
-    for (const Move &move : move_list)
-    {
-        board.make_move(move);
-        u64 new_nodes;
-        try
-        {
-            new_nodes = perf_t(depth - 1, board, expected_nodes);
-            nodes += new_nodes;
-            board.undo_move(move);
-        }
-        catch (const std::exception &e)
-        {
-            std::cout << "Move: " << move.to_UCI() << " led to king capture." << '\n';
-            throw std::runtime_error("King captured.");
-        }
-
-        if (print_divide && depth == print_depth)
-        {
-            // Convert move to UCI notation (e.g., "e2e4")
-            std::string move_str = move.to_UCI(); // Implement this method
-
-            // Output the move and its node count
-            std::cout << move_str << ": " << new_nodes << std::endl;
-        }
-    }
-    return nodes;
-}
 
 // Define a test fixture class for Perft tests
 class PerftTest : public ::testing::Test
 {
 protected:
+    PerftTable table{PERFT_HASH_MB};
+
     void SetUp() override
     {
-        // Initialize progress tracking variables before each test
-        nodes_processed = 0;
-        start_time = std::chrono::steady_clock::now();
-        last_update_time = start_time;
+        init_zobrist_keys();
+        init_attack_tables();
     }
 
-    // Wrapper method to call perf_t with progress tracking
-    u64 run_perft(int depth, BoardRepresentation &board, u64 expected_nodes)
+    u64 run_perft(int depth, BoardRepresentation &board)
     {
-        return perf_t(depth, board, expected_nodes);
+        return perft(board, depth, &table);
+    }
+
+    // A shallow count without the table checks the generator on its own, a table bug cannot hide there
+    void expect_uncached(BoardRepresentation &board, int depth, u64 expected_nodes)
+    {
+        EXPECT_EQ(perft(board, depth), expected_nodes);
     }
 };
 
@@ -89,56 +35,121 @@ protected:
 TEST_F(PerftTest, PerftFromStarting)
 {
     BoardRepresentation board;
-    u64 expected_nodes = 119060324;
-    int depth = print_depth = 6;
-    u64 perf_t_result = run_perft(depth, board, expected_nodes);
-    EXPECT_EQ(perf_t_result, expected_nodes);
+    expect_uncached(board, 5, 4865609ULL);
+    EXPECT_EQ(run_perft(6, board), 119060324ULL);
 }
 
-/*
 TEST_F(PerftTest, PerftPosition2)
 {
     BoardRepresentation board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
-    u64 expected_nodes = 8031647685;
-    int depth = print_depth = 6;
-    u64 perf_t_result = run_perft(depth, board, expected_nodes);
-    EXPECT_EQ(perf_t_result, expected_nodes);
+    expect_uncached(board, 4, 4085603ULL);
+    EXPECT_EQ(run_perft(5, board), 193690690ULL);
 }
 
 TEST_F(PerftTest, PerftPosition3)
 {
     BoardRepresentation board("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
-    u64 expected_nodes = 11030083;
-    int depth = print_depth = 6;
-    u64 perf_t_result = run_perft(depth, board, expected_nodes);
-    EXPECT_EQ(perf_t_result, expected_nodes);
+    expect_uncached(board, 5, 674624ULL);
+    EXPECT_EQ(run_perft(6, board), 11030083ULL);
 }
 
-
 TEST_F(PerftTest, PerftPosition4)
 {
     BoardRepresentation board("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
-    u64 expected_nodes = 706045033;
-    int depth = print_depth = 6;
-    u64 perf_t_result = run_perft(depth, board, expected_nodes);
-    EXPECT_EQ(perf_t_result, expected_nodes);
+    expect_uncached(board, 4, 422333ULL);
+    EXPECT_EQ(run_perft(6, board), 706045033ULL);
 }
 
 TEST_F(PerftTest, PerftPosition5)
 {
     BoardRepresentation board("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8  ");
-    u64 expected_nodes = 89941194;
-    int depth = print_depth = 5;
-    u64 perf_t_result = run_perft(depth, board, expected_nodes);
-    EXPECT_EQ(perf_t_result, expected_nodes);
+    expect_uncached(board, 4, 2103487ULL);
+    EXPECT_EQ(run_perft(5, board), 89941194ULL);
 }
 
 TEST_F(PerftTest, PerftPosition6)
 {
     BoardRepresentation board("r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10");
-    u64 expected_nodes = 6923051137;
-    int depth = print_depth = 6;
-    u64 perf_t_result = run_perft(depth, board, expected_nodes);
-    EXPECT_EQ(perf_t_result, expected_nodes);
+    expect_uncached(board, 4, 3894594ULL);
+    EXPECT_EQ(run_perft(5, board), 164075551ULL);
+}
+
+TEST_F(PerftTest, CountMatchesGeneratedMoves)
+{
+    // The reference positions, plus one with a checking pawn that can be taken en passant
+    const char *fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "8/8/8/2k5/3Pp3/8/8/4K2Q b - d3 0 1",
+    };
+    for (const char *fen : fens)
+    {
+        BoardRepresentation board(fen);
+        MoveList move_list;
+        EXPECT_EQ(count_legal_moves(board), generate_legal_moves(board, move_list)) << fen;
+    }
+}
+
+TEST_F(PerftTest, TableDoesNotChangeCounts)
+{
+    const char *fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    };
+    for (const char *fen : fens)
+    {
+        BoardRepresentation board(fen);
+        u64 without_table = perft(board, 4);
+        EXPECT_EQ(run_perft(4, board), without_table) << fen;
+        EXPECT_EQ(run_perft(4, board), without_table) << fen; // Answered from the table this time
+    }
+}
+
+TEST_F(PerftTest, DivideListsRootMoves)
+{
+    BoardRepresentation board;
+    std::ostringstream out;
+    EXPECT_EQ(perft_divide(board, 2, out), 400ULL);
+    EXPECT_NE(out.str().find("e2e4: 20\n"), std::string::npos);
+    EXPECT_NE(out.str().find("Nodes searched: 400\n"), std::string::npos);
+
+    // The position itself is the only leaf at depth 0
+    EXPECT_EQ(perft_divide(board, 0, out), 1ULL);
+    EXPECT_EQ(perft(board, 0), 1ULL);
+}
+
+TEST_F(PerftTest, ThreadedDivideMatchesSingleThreaded)
+{
+    BoardRepresentation board("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    std::ostringstream single, threaded;
+    u64 single_nodes = perft_divide(board, 4, single);
+    u64 threaded_nodes = perft_divide(board, 4, threaded, &table, 4);
+    EXPECT_EQ(single_nodes, 422333ULL);
+    EXPECT_EQ(threaded_nodes, single_nodes);
+
+    // Everything up to the timing lines is the same
+    std::string single_divide = single.str(), threaded_divide = threaded.str();
+    EXPECT_EQ(threaded_divide.substr(0, threaded_divide.find("Time:")), single_divide.substr(0, single_divide.find("Time:")));
+}
+
+TEST_F(PerftTest, StoppedDivideListsOnlyFinishedMoves)
+{
+    BoardRepresentation board;
+    SearchLimits limits;
+    limits.stop();
+
+    std::ostringstream out;
+    EXPECT_EQ(perft_divide(board, 4, out, &table, 1, &limits), 0ULL);
+    EXPECT_EQ(out.str().find("e2e4:"), std::string::npos);
+
+    // Nothing partial was cached along the way
+    EXPECT_EQ(run_perft(4, board), 197281ULL);
 }
-*/
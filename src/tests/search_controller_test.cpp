@@ -0,0 +1,98 @@
+#include "search_controller.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+TEST(SearchControllerTest, StopReportsBestMoveFromInfiniteSearch)
+{
+    init_zobrist_keys();
+    init_attack_tables();
+    BoardRepresentation board_representation = BoardRepresentation("8/8/8/8/kr5Q/8/8/1R5K w - - 0 1");
+    TranspositionTable transposition_table;
+    std::ostringstream out;
+    SearchController search_controller(out);
+
+    search_controller.go_infinite(board_representation, transposition_table);
+    search_controller.send("readyok"); // the caller stays free while the search runs
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    search_controller.stop();
+
+    EXPECT_EQ(0u, out.str().rfind("readyok\nbestmove h4b4", 0));
+
+    // A bare kings position runs out of depth at once, the bestmove still waits for stop
+    std::ostringstream bare_kings_out;
+    SearchController bare_kings_controller(bare_kings_out);
+    bare_kings_controller.go_infinite(BoardRepresentation("7k/8/8/8/8/8/8/K7 w - - 0 1"), transposition_table);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_EQ(std::string::npos, bare_kings_out.str().find("bestmove"));
+    bare_kings_controller.stop();
+    EXPECT_EQ(0u, bare_kings_out.str().rfind("bestmove ", 0));
+}
+
+TEST(SearchControllerTest, PonderWaitsForPonderhit)
+{
+    init_zobrist_keys();
+    init_attack_tables();
+    BoardRepresentation board_representation = BoardRepresentation("7k/8/8/8/8/8/8/K7 w - - 0 1");
+    TranspositionTable transposition_table;
+    std::ostringstream out;
+    SearchController search_controller(out);
+
+    search_controller.go_ponder(board_representation, transposition_table, 30000, 30000, 0, 0, -1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_EQ(std::string::npos, out.str().find("bestmove"));
+
+    // The search is long finished, so ponderhit reports it right away
+    search_controller.on_ponder_hit();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(0u, out.str().rfind("bestmove ", 0));
+    search_controller.stop();
+}
+
+TEST(SearchControllerTest, AbortDropsBestMove)
+{
+    init_zobrist_keys();
+    init_attack_tables();
+    BoardRepresentation board_representation;
+    TranspositionTable transposition_table;
+    std::ostringstream out;
+    SearchController search_controller(out);
+
+    search_controller.go_ponder(board_representation, transposition_table, 30000, 30000, 0, 0, -1);
+    search_controller.abort();
+
+    EXPECT_EQ("", out.str());
+}
+
+TEST(SearchControllerTest, StopEndsPerft)
+{
+    init_zobrist_keys();
+    init_attack_tables();
+    BoardRepresentation board_representation;
+    std::ostringstream out;
+    SearchController search_controller(out);
+
+    // Far too deep to finish, the loop stays free and stop cuts it short
+    search_controller.go_perft(board_representation, 12);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    search_controller.stop();
+
+    EXPECT_NE(std::string::npos, out.str().find("Nodes searched: "));
+}
+
+TEST(SearchControllerTest, StopEndsBench)
+{
+    init_zobrist_keys();
+    init_attack_tables();
+    std::ostringstream out;
+    SearchController search_controller(out);
+
+    // The loop stays free while the bench runs, and stop reports the positions done so far
+    search_controller.go_bench(BENCH_DEPTH);
+    search_controller.send("readyok");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    search_controller.stop();
+
+    EXPECT_EQ(0u, out.str().rfind("readyok\n", 0));
+    EXPECT_NE(std::string::npos, out.str().find("Nodes searched: "));
+    EXPECT_EQ(std::string::npos, out.str().find("Position 41/41"));
+}
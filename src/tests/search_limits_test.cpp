@@ -0,0 +1,46 @@
+#include "evaluation.h"
+#include "search_limits.h"
+#include <gtest/gtest.h>
+
+TEST(SearchLimitsTest, NodeLimitRaisesStop)
+{
+    SearchLimits limits;
+    limits.max_nodes = 3;
+
+    limits.count_node();
+    limits.count_node();
+    EXPECT_FALSE(limits.stopped());
+    limits.count_node();
+    EXPECT_TRUE(limits.stopped());
+}
+
+TEST(SearchLimitsTest, ClockOnlyCountsOnceStarted)
+{
+    SearchLimits limits;
+    limits.set_time_budget(std::chrono::milliseconds(0));
+
+    limits.check_clock();
+    EXPECT_FALSE(limits.stopped());
+
+    limits.start_clock();
+    limits.check_clock();
+    EXPECT_TRUE(limits.stopped());
+
+    limits.reset();
+    EXPECT_FALSE(limits.stopped());
+}
+
+TEST(SearchLimitsTest, DepthLimitEndsIterativeDeepening)
+{
+    init_zobrist_keys();
+    init_attack_tables();
+    BoardRepresentation board_representation = BoardRepresentation("8/8/8/8/kr5Q/8/8/1R5K w - - 0 1");
+    TranspositionTable transposition_table;
+    SearchLimits limits;
+    limits.max_depth = 2;
+
+    Evaluation eval = run_iterative_deepening(board_representation, transposition_table, false, limits);
+
+    EXPECT_EQ("h4b4", eval.best_move.to_UCI());
+    EXPECT_FALSE(limits.stopped());
+}
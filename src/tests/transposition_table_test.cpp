@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "transposition_table.h"
+
+TEST(TranspositionTableTest, BucketFillsCacheLine)
+{
+    EXPECT_EQ(sizeof(TranspositionBucket), 64u);
+    EXPECT_EQ(alignof(TranspositionBucket), 64u);
+}
+
+TEST(TranspositionTableTest, SizeIsPowerOfTwo)
+{
+    TranspositionTable transposition_table(3);
+    EXPECT_EQ(transposition_table.size_in_bytes(), 2u * 1024 * 1024);
+
+    transposition_table.resize(8);
+    EXPECT_EQ(transposition_table.size_in_bytes(), 8u * 1024 * 1024);
+}
+
+TEST(TranspositionTableTest, StoreAndProbe)
+{
+    TranspositionTable transposition_table(1);
+    Move best_move = Move(12, 28);
+    Move best_response = Move(52, 60, PROMOTION, 'n');
+    transposition_table.insert(0x123456789ABCDEFULL, -999997, 5, best_move, best_response, EntryType::Beta);
+
+    TranspositionRow row;
+    ASSERT_TRUE(transposition_table.get(0x123456789ABCDEFULL, row));
+    EXPECT_EQ(row.eval, -999997);
+    EXPECT_EQ(row.depth, 5);
+    EXPECT_TRUE(row.best_move == best_move);
+    EXPECT_TRUE(row.best_response == best_response);
+    EXPECT_EQ(row.entry_type, EntryType::Beta);
+
+    EXPECT_FALSE(transposition_table.get(0xFEDCBA987654321ULL, row));
+
+    transposition_table.reset_table();
+    EXPECT_FALSE(transposition_table.get(0x123456789ABCDEFULL, row));
+}
+
+TEST(TranspositionTableTest, KeepsDeeperEntry)
+{
+    TranspositionTable transposition_table(1);
+    std::uint64_t hash = 0xABCDEF0123ULL;
+    transposition_table.insert(hash, 40, 6, Move(12, 28), Move(), EntryType::PV);
+    transposition_table.insert(hash, 10, 3, Move(11, 27), Move(), EntryType::PV);
+
+    TranspositionRow row;
+    ASSERT_TRUE(transposition_table.get(hash, row));
+    EXPECT_EQ(row.eval, 40);
+    EXPECT_EQ(row.depth, 6);
+
+    transposition_table.insert(hash, 25, 8, Move(11, 27), Move(), EntryType::Alpha);
+    ASSERT_TRUE(transposition_table.get(hash, row));
+    EXPECT_EQ(row.eval, 25);
+    EXPECT_EQ(row.depth, 8);
+}
+
+TEST(TranspositionTableTest, ReplacesEntriesFromOldSearches)
+{
+    TranspositionTable transposition_table(1);
+
+    // Hashes sharing one bucket differ only above the index bits
+    std::uint64_t bucket_stride = transposition_table.size_in_bytes() / sizeof(TranspositionBucket);
+    for (std::uint64_t i = 1; i <= BUCKET_SIZE; ++i)
+    {
+        transposition_table.insert(i * bucket_stride, 0, 10, Move(), Move(), EntryType::PV);
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        transposition_table.age_table();
+    }
+    transposition_table.insert((BUCKET_SIZE + 1) * bucket_stride, 0, 2, Move(), Move(), EntryType::PV);
+
+    TranspositionRow row;
+    EXPECT_TRUE(transposition_table.get((BUCKET_SIZE + 1) * bucket_stride, row));
+}
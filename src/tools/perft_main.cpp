@@ -0,0 +1,64 @@
+// perft_main.cpp
+// Standalone perft: perft <depth> [--hash <megabytes>] [--threads <count>] [fen]
+// Prints the divide of the position (the starting position without a fen). --hash 0 turns the cache off,
+// and the work is spread over every hardware thread unless --threads says otherwise.
+#include "attack_tables.h"
+#include "board_representation.h"
+#include "perft.h"
+#include "zobrist_values.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <depth> [--hash <megabytes>] [--threads <count>] [fen]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        int depth = std::stoi(argv[1]);
+        std::size_t hash_mb = PERFT_HASH_MB;
+        int threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1U));
+        std::string fen;
+        for (int i = 2; i < argc; ++i)
+        {
+            std::string argument = argv[i];
+            if (argument == "--hash" && i + 1 < argc)
+            {
+                hash_mb = std::stoul(argv[++i]);
+            }
+            else if (argument == "--threads" && i + 1 < argc)
+            {
+                threads = std::stoi(argv[++i]);
+            }
+            else
+            {
+                fen += fen.empty() ? argument : " " + argument;
+            }
+        }
+
+        init_zobrist_keys();
+        init_attack_tables();
+        BoardRepresentation board = fen.empty() ? BoardRepresentation() : BoardRepresentation(fen);
+
+        std::unique_ptr<PerftTable> table;
+        if (hash_mb > 0)
+        {
+            table = std::make_unique<PerftTable>(hash_mb);
+        }
+        perft_divide(board, depth, std::cout, table.get(), threads);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,12 +1,74 @@
 // transposition_table.cpp
 #include "transposition_table.h"
+#include <algorithm>
 #include <string>
 
+namespace
+{
+    constexpr int EVAL_BITS = 21;
+    constexpr int DEPTH_BITS = 6;
+    constexpr int AGE_BITS = 3;
+    constexpr std::uint64_t EVAL_MASK = (1ULL << EVAL_BITS) - 1;
+    constexpr std::uint64_t DEPTH_MASK = (1ULL << DEPTH_BITS) - 1;
+    constexpr std::uint64_t AGE_MASK = (1ULL << AGE_BITS) - 1;
+    constexpr int MAX_STORED_EVAL = (1 << (EVAL_BITS - 1)) - 1;
+
+    std::uint64_t pack(int eval, int depth, const Move &best_move, const Move &best_response, EntryType entry_type, int age)
+    {
+        eval = std::clamp(eval, -MAX_STORED_EVAL, MAX_STORED_EVAL);
+        depth = std::clamp(depth, 0, static_cast<int>(DEPTH_MASK));
+
+        return static_cast<std::uint64_t>(best_move.data) |
+               (static_cast<std::uint64_t>(best_response.data) << 16) |
+               ((static_cast<std::uint64_t>(eval) & EVAL_MASK) << 32) |
+               (static_cast<std::uint64_t>(depth) << 53) |
+               (static_cast<std::uint64_t>(entry_type) << 59) |
+               ((static_cast<std::uint64_t>(age) & AGE_MASK) << 61);
+    }
+
+    int unpack_depth(std::uint64_t data)
+    {
+        return static_cast<int>((data >> 53) & DEPTH_MASK);
+    }
+
+    int unpack_age(std::uint64_t data)
+    {
+        return static_cast<int>(data >> 61);
+    }
+
+    TranspositionRow unpack(std::uint64_t data)
+    {
+        Move best_move, best_response;
+        best_move.data = static_cast<std::uint16_t>(data);
+        best_response.data = static_cast<std::uint16_t>(data >> 16);
+
+        // Sign extend the eval field
+        int eval = static_cast<int>((data >> 32) & EVAL_MASK);
+        if (eval > MAX_STORED_EVAL)
+        {
+            eval -= 1 << EVAL_BITS;
+        }
+
+        return TranspositionRow(eval,
+                                unpack_depth(data),
+                                best_move,
+                                best_response,
+                                static_cast<EntryType>((data >> 59) & 3),
+                                unpack_age(data));
+    }
+
+    // Searches since the entry was last written
+    int age_distance(int current_age, std::uint64_t data)
+    {
+        return static_cast<int>(static_cast<std::uint64_t>(current_age - unpack_age(data)) & AGE_MASK);
+    }
+}
+
 // -----------------------
 // TranspositionRow
 // -----------------------
 TranspositionRow::TranspositionRow()
-    : eval(0), depth(0), age(0), best_move(), best_response(), entry_type(EntryType::Alpha)
+    : eval(0), best_move(), best_response(), depth(0), age(0), entry_type(EntryType::Alpha)
 {
 }
 
@@ -16,16 +78,37 @@ TranspositionRow::TranspositionRow(int eval_,
                                    const Move &best_response_,
                                    EntryType entry_type_,
                                    int age_)
-    : eval(eval_), depth(depth_), age(age_), best_move(best_move_), best_response(best_response_), entry_type(entry_type_)
+    : eval(eval_),
+      best_move(best_move_),
+      best_response(best_response_),
+      depth(static_cast<std::int16_t>(depth_)),
+      age(static_cast<std::uint8_t>(age_)),
+      entry_type(entry_type_)
 {
 }
 
 // -----------------------
 // TranspositionTable
 // -----------------------
-TranspositionTable::TranspositionTable()
-    : table(), current_age(0), mutex_()
+TranspositionTable::TranspositionTable(std::size_t megabytes)
+    : buckets(), bucket_count(0), current_age(0)
 {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(std::size_t megabytes)
+{
+    megabytes = std::clamp<std::size_t>(megabytes, 1, MAX_HASH_MB);
+    std::size_t max_buckets = megabytes * 1024 * 1024 / sizeof(TranspositionBucket);
+
+    bucket_count = 1;
+    while (bucket_count * 2 <= max_buckets)
+    {
+        bucket_count *= 2;
+    }
+
+    buckets = std::make_unique<TranspositionBucket[]>(bucket_count);
+    current_age = 0;
 }
 
 void TranspositionTable::insert(std::uint64_t hash,
@@ -35,91 +118,86 @@ void TranspositionTable::insert(std::uint64_t hash,
                                 const Move &best_response,
                                 EntryType entry_type)
 {
-    if (depth < MIN_TRANSPOSITION_DEPTH)
+    if (depth < QUIESCENCE_DEPTH)
         throw std::runtime_error("Search not deep enough to store in TT.");
 
-    std::unique_lock lock(mutex_);
+    int age = current_age.load(std::memory_order_relaxed);
+    TranspositionBucket &bucket = bucket_for(hash);
+    TranspositionEntry *replace = nullptr;
+    int lowest_worth = 0;
 
-    auto it = table.find(hash);
-    if (it != table.end())
+    for (TranspositionEntry &entry : bucket.entries)
     {
-        // refresh age
-        it->second.age = current_age;
-        // replace only if deeper
-        if (depth > it->second.depth)
+        std::uint64_t data = entry.data.load(std::memory_order_relaxed);
+        std::uint64_t key = entry.key.load(std::memory_order_relaxed);
+
+        if ((key ^ data) == hash)
         {
-            it->second.eval = eval;
-            it->second.depth = depth;
-            it->second.best_move = best_move;
-            it->second.best_response = best_response;
-            it->second.entry_type = entry_type;
+            // Same position: replace unless shallower, otherwise keep the deeper result and refresh its age
+            if (depth < unpack_depth(data))
+            {
+                if (age_distance(age, data) != 0)
+                {
+                    TranspositionRow row = unpack(data);
+                    std::uint64_t refreshed = pack(row.eval, row.depth, row.best_move, row.best_response, row.entry_type, age);
+                    entry.data.store(refreshed, std::memory_order_relaxed);
+                    entry.key.store(hash ^ refreshed, std::memory_order_relaxed);
+                }
+                return;
+            }
+            replace = &entry;
+            break;
+        }
+
+        if ((key == 0 && data == 0) || age_distance(age, data) > OLDEST_AGE_TO_HOLD)
+        {
+            // Empty slot or one left by a long finished search
+            replace = &entry;
+            break;
+        }
+
+        // Prefer overwriting shallow entries from old searches
+        int worth = unpack_depth(data) - 8 * age_distance(age, data);
+        if (!replace || worth < lowest_worth)
+        {
+            replace = &entry;
+            lowest_worth = worth;
         }
     }
-    else
-    {
-        table.emplace(hash,
-                      TranspositionRow(eval,
-                                       depth,
-                                       best_move,
-                                       best_response,
-                                       entry_type,
-                                       current_age));
-    }
+
+    std::uint64_t data = pack(eval, depth, best_move, best_response, entry_type, age);
+    replace->data.store(data, std::memory_order_relaxed);
+    replace->key.store(hash ^ data, std::memory_order_relaxed);
 }
 
-const TranspositionRow *TranspositionTable::get(std::uint64_t hash)
+bool TranspositionTable::get(std::uint64_t hash, TranspositionRow &row) const
 {
-    std::unique_lock lock(mutex_);
-
-    auto it = table.find(hash);
-    if (it != table.end())
+    for (const TranspositionEntry &entry : bucket_for(hash).entries)
     {
-        // refresh age
-        it->second.age = current_age;
-        return &it->second;
+        std::uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if ((entry.key.load(std::memory_order_relaxed) ^ data) == hash)
+        {
+            row = unpack(data);
+            return true;
+        }
     }
-    return nullptr;
+    return false;
 }
 
 void TranspositionTable::reset_table()
 {
-    std::unique_lock lock(mutex_);
     current_age = 0;
-    table.clear();
-}
-
-void TranspositionTable::age_table()
-{
-    std::unique_lock lock(mutex_);
-    ++current_age;
-}
-
-void TranspositionTable::maintain_table()
-{
-    std::unique_lock lock(mutex_);
-    auto &logger = ThreadSafeLogger::getInstance("logs/app_log.txt");
-
-    size_t initial_size = table.size();
-    logger.write("Debug",
-                 "Before prune: " + std::to_string(initial_size) +
-                     " entries in TT");
-
-    size_t deleted = 0;
-    for (auto it = table.begin(); it != table.end();)
+    for (std::size_t i = 0; i < bucket_count; ++i)
     {
-        if (current_age - it->second.age > OLDEST_AGE_TO_HOLD)
-        {
-            it = table.erase(it);
-            ++deleted;
-        }
-        else
+        for (TranspositionEntry &entry : buckets[i].entries)
         {
-            ++it;
+            entry.key.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
         }
     }
+}
 
-    logger.write("Debug",
-                 "Pruned " + std::to_string(deleted) +
-                     " old entries; remaining " +
-                     std::to_string(table.size()));
+void TranspositionTable::age_table()
+{
+    ++current_age;
 }